@@ -0,0 +1,9 @@
+#include "buffer/buffer_access_strategy.h"
+
+#include "buffer/buffer_pool_manager.h"
+
+BufferAccessStrategy::~BufferAccessStrategy() {
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->CancelPrefetch(this);
+  }
+}
@@ -1,229 +1,554 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <chrono>
+#include <new>
+#include <vector>
+
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
 static const char EMPTY_PAGE_DATA[PAGE_SIZE] = {0};
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager) {
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size_);
-  for (size_t i = 0; i < pool_size_; i++) {
-    free_list_.emplace_back(i);
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances,
+                                     ReplacerType replacer_type, size_t max_pool_size)
+    : pool_size_(0), replacer_type_(replacer_type), disk_manager_(disk_manager) {
+  max_pool_size_ = std::max(pool_size, max_pool_size);
+  // every shard owns at least one frame
+  num_instances_ = std::max<size_t>(1, std::min(num_instances, pool_size));
+  // the arena is address space for the largest pool, the OS backs a frame with memory once it is written. So is the
+  // room for the bookkeeping, a Page is only constructed in a frame in use.
+  arena_ = std::make_unique<FrameArena>(max_pool_size_);
+  pages_ = static_cast<Page *>(operator new[](max_pool_size_ * sizeof(Page), std::align_val_t(alignof(Page))));
+  shards_ = new Shard[num_instances_];
+  for (size_t i = 0; i < num_instances_; i++) {
+    shards_[i].replacer_ = CreateReplacer(replacer_type_, 0);
+    GrowShard(shards_[i], ShardSize(i, pool_size));
   }
+  bg_writer_ = std::thread(&BufferPoolManager::BackgroundWriter, this);
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page : page_table_) {
-    FlushPage(page.first);
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    prefetch_stop_ = true;
+    prefetch_cv_.notify_all();
+  }
+  if (prefetch_worker_.joinable()) {
+    prefetch_worker_.join();
+  }
+  {
+    std::lock_guard<std::mutex> guard(bg_writer_latch_);
+    bg_writer_stop_ = true;
+    bg_writer_cv_.notify_all();
+  }
+  bg_writer_.join();
+  FlushAllPages();
+  for (size_t i = 0; i < num_instances_; i++) {
+    for (size_t local_frame_id = 0; local_frame_id < shards_[i].size_; local_frame_id++) {
+      pages_[ToFrameId(shards_[i], static_cast<frame_id_t>(local_frame_id))].~Page();
+    }
+    delete shards_[i].replacer_;
   }
-  delete[] pages_;
-  delete replacer_;
+  delete[] shards_;
+  operator delete[](pages_, std::align_val_t(alignof(Page)));
 }
 
-/**
- * TODO: Student Implement
- */
-Page *BufferPoolManager::FetchPage(page_id_t page_id) {
-    std::lock_guard<std::recursive_mutex> guard(latch_); 
-    auto page_table_iter = page_table_.find(page_id);
-
-    if (page_table_iter != page_table_.end()) {
-        frame_id_t frame_id_in_pool = page_table_iter->second; 
-        Page* page_in_frame = &pages_[frame_id_in_pool];     
-        page_in_frame->pin_count_++;
-        replacer_->Pin(frame_id_in_pool); 
-        return page_in_frame;
+size_t BufferPoolManager::Resize(size_t pool_size) {
+  std::lock_guard<std::mutex> resize_guard(resize_latch_);
+  pool_size = std::min(std::max(pool_size, num_instances_), max_pool_size_);
+  size_t end_frame = 0;  // frames from here on are retired
+  for (size_t i = 0; i < num_instances_; i++) {
+    Shard &shard = shards_[i];
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    size_t shard_size = ShardSize(i, pool_size);
+    if (shard_size > shard.size_) {
+      GrowShard(shard, shard_size);
+    } else {
+      ShrinkShard(shard, lock, shard_size);
     }
+    end_frame = std::max<size_t>(end_frame, ToFrameId(shard, static_cast<frame_id_t>(shard.size_ - 1)) + 1);
+  }
+  // the memory of the frames above the last one in use goes back to the OS
+  arena_->Release(end_frame, max_pool_size_);
+  return pool_size_;
+}
 
+void BufferPoolManager::GrowShard(Shard &shard, size_t size) {
+  shard.replacer_->Resize(size);
+  for (; shard.size_ < size; shard.size_++) {
+    frame_id_t frame_id = ToFrameId(shard, static_cast<frame_id_t>(shard.size_));
+    new (&pages_[frame_id]) Page(arena_->GetFrame(frame_id));
+    shard.free_list_.push_back(frame_id);
+    pool_size_++;
+  }
+}
 
-    frame_id_t frame_id_to_use; 
-
-    if (!free_list_.empty()) {
-        frame_id_to_use = free_list_.front(); 
-        free_list_.pop_front();              
-    } else { 
-        if (!replacer_->Victim(&frame_id_to_use)) { 
-            //LOG(WARNING) << "BufferPoolManager::FetchPage: No victim available from replacer.";
-            return nullptr; 
-        }
-        Page* victim_page_ptr = &pages_[frame_id_to_use];
-        if (victim_page_ptr->IsDirty()) {
-            disk_manager_->WritePage(victim_page_ptr->GetPageId(), victim_page_ptr->GetData());
-            victim_page_ptr->is_dirty_ = false; 
-        }
-        page_table_.erase(victim_page_ptr->GetPageId()); 
-
+void BufferPoolManager::ShrinkShard(Shard &shard, unique_lock<mutex> &lock, size_t size) {
+  // free frames above size leave the free list up front, so that no new page is put there
+  std::vector<frame_id_t> unlisted;
+  for (auto iter = shard.free_list_.begin(); iter != shard.free_list_.end();) {
+    if (static_cast<size_t>(ToLocalFrameId(*iter)) >= size) {
+      unlisted.push_back(*iter);
+      iter = shard.free_list_.erase(iter);
+    } else {
+      ++iter;
     }
+  }
+  while (shard.size_ > size) {
+    frame_id_t frame_id = ToFrameId(shard, static_cast<frame_id_t>(shard.size_ - 1));
+    Page *page = &pages_[frame_id];
+    if (page->io_pending_ || page->flushing_) {
+      page->io_done_.wait(lock, [page] { return !page->io_pending_ && !page->flushing_; });
+      continue;
+    }
+    // a frame whose read failed is still pinned by the threads that found it, until they let go
+    if (page->pin_count_ != 0) {
+      break;
+    }
+    if (page->page_id_ != INVALID_PAGE_ID) {
+      if (page->IsDirty()) {
+        // the frame may be evicted and reused meanwhile, it is looked at again
+        WriteBack(shard, lock, frame_id);
+        continue;
+      }
+      shard.page_table_.erase(page->page_id_);
+      shard.replacer_->Remove(ToLocalFrameId(frame_id));
+      page->page_id_ = INVALID_PAGE_ID;
+      page->prefetched_ = false;
+    }
+    // nobody looks at the frame any more, the threads that waited for its I/O wait on the shard's state
+    page->~Page();
+    shard.size_--;
+    pool_size_--;
+  }
+  shard.replacer_->Resize(shard.size_);
+  // a page deleted while a write-back ran may have put a retired frame back on the free list
+  shard.free_list_.remove_if([this, &shard](frame_id_t frame_id) {
+    return static_cast<size_t>(ToLocalFrameId(frame_id)) >= shard.size_;
+  });
+  for (auto frame_id : unlisted) {
+    if (static_cast<size_t>(ToLocalFrameId(frame_id)) < shard.size_) {
+      shard.free_list_.push_back(frame_id);
+    }
+  }
+  shard.writer_cursor_ = 0;
+}
 
-    Page* new_page_in_frame = &pages_[frame_id_to_use];
-
-    new_page_in_frame->page_id_ = page_id;        
-    new_page_in_frame->pin_count_ = 1;             
-    new_page_in_frame->is_dirty_ = false;      
-    new_page_in_frame->ResetMemory();              
-    
-    page_table_[page_id] = frame_id_to_use;
+Replacer *BufferPoolManager::CreateReplacer(ReplacerType replacer_type, size_t num_pages) {
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      return new CLOCKReplacer(num_pages);
+    case ReplacerType::LRU_K:
+      return new LRUKReplacer(num_pages);
+    case ReplacerType::LRU:
+    default:
+      return new LRUReplacer(num_pages);
+  }
+}
 
-    disk_manager_->ReadPage(page_id, new_page_in_frame->GetData()); 
+frame_id_t BufferPoolManager::TryToFindFreePage(Shard &shard, page_id_t page_id, page_id_t &evicted_page_id,
+                                                BufferAccessStrategy *strategy) {
+  evicted_page_id = INVALID_PAGE_ID;
+  BufferAccessStrategy::Ring *ring = nullptr;
+  pair<frame_id_t, page_id_t> *slot = nullptr;
+  if (strategy != nullptr && strategy->GetType() != AccessStrategyType::NORMAL) {
+    ring = &strategy->rings_[&shard - shards_];
+    size_t ring_size = std::max<size_t>(1, strategy->GetRingSize() / num_instances_);
+    if (ring->slots_.size() >= ring_size) {
+      slot = &ring->slots_[ring->next_];
+      ring->next_ = (ring->next_ + 1) % ring->slots_.size();
+      Page *page = &pages_[slot->first];
+      // reuse the frame only if it is still in use and holds the page this ring put there
+      if (static_cast<size_t>(ToLocalFrameId(slot->first)) < shard.size_ && page->page_id_ == slot->second &&
+          page->pin_count_ == 0) {
+        shard.replacer_->Remove(ToLocalFrameId(slot->first));
+        EvictFrame(shard, slot->first, evicted_page_id);
+        slot->second = page_id;
+        return slot->first;
+      }
+    }
+  }
+  frame_id_t frame_id;
+  if (!shard.free_list_.empty()) {
+    frame_id = shard.free_list_.front();
+    shard.free_list_.pop_front();
+  } else {
+    frame_id_t local_frame_id;
+    do {
+      if (!shard.replacer_->Victim(&local_frame_id)) {
+        return INVALID_FRAME_ID;
+      }
+      frame_id = ToFrameId(shard, local_frame_id);
+      // a page being flushed is pinned by the flusher, it rejoins the replacer when the flush is done
+    } while (pages_[frame_id].pin_count_ != 0);
+    EvictFrame(shard, frame_id, evicted_page_id);
+  }
+  if (slot != nullptr) {
+    *slot = {frame_id, page_id};
+  } else if (ring != nullptr) {
+    ring->slots_.emplace_back(frame_id, page_id);
+  }
+  return frame_id;
+}
 
-    replacer_->Pin(frame_id_to_use);      
+void BufferPoolManager::EvictFrame(Shard &shard, frame_id_t frame_id, page_id_t &evicted_page_id) {
+  Page *victim = &pages_[frame_id];
+  shard.page_table_.erase(victim->GetPageId());
+  victim->prefetched_ = false;
+  if (victim->IsDirty()) {
+    evicted_page_id = victim->GetPageId();
+    shard.evicting_[evicted_page_id] = frame_id;
+    victim->is_dirty_ = false;
+    shard.stats_.dirty_pages_--;
+  }
+}
 
-    return new_page_in_frame; 
+bool BufferPoolManager::LoadFrame(Shard &shard, unique_lock<mutex> &lock, frame_id_t frame_id,
+                                  page_id_t evicted_page_id, bool read_from_disk) {
+  Page *page = &pages_[frame_id];
+  page->io_pending_ = true;
+  lock.unlock();
+  // the frame is pinned and io_pending_, nobody else touches its data or page id until the I/O is done
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    disk_manager_->WritePage(evicted_page_id, page->GetData());
+  }
+  bool ok = true;
+  if (read_from_disk) {
+    ok = disk_manager_->ReadPage(page->page_id_, page->GetData());
+  } else {
+    page->ResetMemory();
+  }
+  lock.lock();
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    shard.evicting_.erase(evicted_page_id);
+  }
+  page->io_pending_ = false;
+  if (!ok) {
+    // a damaged page is never handed out, the threads waiting for it see that it is gone
+    shard.page_table_.erase(page->page_id_);
+    page->page_id_ = INVALID_PAGE_ID;
+    page->prefetched_ = false;
+    ReleaseFrame(shard, frame_id);
+  }
+  page->io_done_.notify_all();
+  return ok;
+}
 
+void BufferPoolManager::ReleaseFrame(Shard &shard, frame_id_t frame_id) {
+  if (--pages_[frame_id].pin_count_ == 0) {
+    shard.replacer_->Remove(ToLocalFrameId(frame_id));
+    shard.free_list_.push_back(frame_id);
+  }
 }
 
 /**
  * TODO: Student Implement
  */
-Page *BufferPoolManager::NewPage(page_id_t &page_id) {
-
-      std::lock_guard<std::recursive_mutex> guard(latch_);
-
-    frame_id_t frame_id_to_use;
-
-    if (free_list_.empty() && replacer_->Size() == 0) {
-       page_id = INVALID_PAGE_ID;
+Page *BufferPoolManager::FetchPage(page_id_t page_id) { return FetchPage(page_id, nullptr); }
+
+Page *BufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  PrepareStrategy(strategy);
+  Shard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  while (true) {
+    auto page_table_iter = shard.page_table_.find(page_id);
+    if (page_table_iter != shard.page_table_.end()) {
+      frame_id_t frame_id = page_table_iter->second;
+      Page *page = &pages_[frame_id];
+      page->pin_count_++;
+      shard.replacer_->Pin(ToLocalFrameId(frame_id));
+      shard.stats_.hits_++;
+      if (page->prefetched_) {
+        page->prefetched_ = false;
+        shard.stats_.prefetch_hits_++;
+      }
+      // another thread is still reading the page in
+      page->io_done_.wait(lock, [page] { return !page->io_pending_; });
+      if (page->page_id_ != page_id) {
+        // and failed to
+        ReleaseFrame(shard, frame_id);
         return nullptr;
+      }
+      return page;
     }
-
-    if (!free_list_.empty()) {
-        frame_id_to_use = free_list_.front(); 
-        free_list_.pop_front();             
-        } else { 
-        if (!replacer_->Victim(&frame_id_to_use)) {
-            page_id = INVALID_PAGE_ID;
-            return nullptr; 
-        }
-        Page* victim_page_ptr = &pages_[frame_id_to_use];
-       
-        if (victim_page_ptr->IsDirty()) {
-            disk_manager_->WritePage(victim_page_ptr->GetPageId(), victim_page_ptr->GetData());
-            victim_page_ptr->is_dirty_ = false;
-        }
-      
-        page_table_.erase(victim_page_ptr->GetPageId());
-          }
-
-    page_id_t new_on_disk_page_id = disk_manager_->AllocatePage();
-    if (new_on_disk_page_id == INVALID_PAGE_ID) {
-        LOG(ERROR) << "BufferPoolManager::NewPage (Optimized): DiskManager failed to allocate a new page on disk.";
-        pages_[frame_id_to_use].page_id_ = INVALID_PAGE_ID; 
-        pages_[frame_id_to_use].pin_count_ = 0;
-        pages_[frame_id_to_use].is_dirty_ = false;
-
-        free_list_.push_front(frame_id_to_use);
-
-        page_id = INVALID_PAGE_ID;
-        return nullptr;
+    // the page has just been evicted and its write-back is still in flight, the disk copy is stale until it is done
+    auto evicting_iter = shard.evicting_.find(page_id);
+    if (evicting_iter == shard.evicting_.end()) {
+      break;
     }
+    Page *writer = &pages_[evicting_iter->second];
+    writer->io_done_.wait(lock, [&shard, page_id] { return shard.evicting_.count(page_id) == 0; });
+  }
 
-    Page* new_page_in_frame = &pages_[frame_id_to_use];
-    
-    new_page_in_frame->page_id_ = new_on_disk_page_id; 
-    
-    new_page_in_frame->pin_count_ = 1;
- 
-    new_page_in_frame->is_dirty_ = false; 
-    new_page_in_frame->ResetMemory(); 
-
-    page_table_[new_on_disk_page_id] = frame_id_to_use;
-
-    replacer_->Pin(frame_id_to_use); 
-
-    page_id = new_on_disk_page_id;
+  page_id_t evicted_page_id;
+  frame_id_t frame_id = TryToFindFreePage(shard, page_id, evicted_page_id, strategy);
+  if (frame_id == INVALID_FRAME_ID) {
+    return nullptr;
+  }
+  shard.stats_.misses_++;
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  shard.page_table_[page_id] = frame_id;
+  shard.replacer_->Pin(ToLocalFrameId(frame_id));
+  if (!LoadFrame(shard, lock, frame_id, evicted_page_id, true)) {
+    return nullptr;
+  }
+  return page;
+}
 
-    return new_page_in_frame;
+/**
+ * TODO: Student Implement
+ */
+Page *BufferPoolManager::NewPage(page_id_t &page_id) { return NewPage(page_id, nullptr); }
+
+Page *BufferPoolManager::NewPage(page_id_t &page_id, BufferAccessStrategy *strategy) {
+  PrepareStrategy(strategy);
+  page_id = INVALID_PAGE_ID;
+  // the shard is chosen by the page id, so the page has to be allocated on disk first
+  page_id_t new_page_id = AllocatePage();
+  if (new_page_id == INVALID_PAGE_ID) {
+    LOG(ERROR) << "BufferPoolManager::NewPage: DiskManager failed to allocate a new page on disk.";
+    return nullptr;
+  }
+  Shard &shard = GetShard(new_page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  page_id_t evicted_page_id;
+  frame_id_t frame_id = TryToFindFreePage(shard, new_page_id, evicted_page_id, strategy);
+  if (frame_id == INVALID_FRAME_ID) {
+    lock.unlock();
+    DeallocatePage(new_page_id);
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page->page_id_ = new_page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  shard.page_table_[new_page_id] = frame_id;
+  shard.replacer_->Pin(ToLocalFrameId(frame_id));
+  if (evicted_page_id != INVALID_PAGE_ID) {
+    LoadFrame(shard, lock, frame_id, evicted_page_id, false);
+  } else {
+    page->ResetMemory();
+  }
+  page_id = new_page_id;
+  return page;
 }
 
 /**
  * TODO: Student Implement
  */
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-  std::lock_guard<std::recursive_mutex> guard(latch_);
-    auto page_table_iter = page_table_.find(page_id);
-    if (page_table_iter == page_table_.end()) {
-        disk_manager_->DeAllocatePage(page_id);
-        return true; // 操作视为完成，因为缓冲池无事可做
-    }
-
-    frame_id_t frame_id_of_page = page_table_iter->second;
-    Page* page_to_delete_ptr = &pages_[frame_id_of_page];
-    if (page_to_delete_ptr->GetPinCount() != 0) {
-       
-        return false; 
-    }
-
-    page_table_.erase(page_table_iter);
-
-    page_to_delete_ptr->ResetMemory();
-    page_to_delete_ptr->page_id_ = INVALID_PAGE_ID;
-    page_to_delete_ptr->pin_count_ = 0;
-    page_to_delete_ptr->is_dirty_ = false; 
-    free_list_.push_back(frame_id_of_page);
-
-    replacer_->Pin(frame_id_of_page);
-
-    disk_manager_->DeAllocatePage(page_id);
+  Shard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto evicting_iter = shard.evicting_.find(page_id);
+  if (evicting_iter != shard.evicting_.end()) {
+    // let the write-back finish so that it can not land after the page has been reused
+    Page *writer = &pages_[evicting_iter->second];
+    writer->io_done_.wait(lock, [&shard, page_id] { return shard.evicting_.count(page_id) == 0; });
+  }
+  auto page_table_iter = shard.page_table_.find(page_id);
+  while (page_table_iter != shard.page_table_.end() && pages_[page_table_iter->second].flushing_) {
+    // the flusher's pin is not a user's, the page is looked up again as its frame may be retired meanwhile
+    pages_[page_table_iter->second].io_done_.wait(lock);
+    page_table_iter = shard.page_table_.find(page_id);
+  }
+  if (page_table_iter == shard.page_table_.end()) {
+    DeallocatePage(page_id);
     return true;
+  }
+  frame_id_t frame_id = page_table_iter->second;
+  Page *page = &pages_[frame_id];
+  if (page->GetPinCount() != 0) {
+    return false;
+  }
+  shard.page_table_.erase(page_table_iter);
+  if (page->IsDirty()) {
+    shard.stats_.dirty_pages_--;
+  }
+  page->prefetched_ = false;
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  shard.replacer_->Remove(ToLocalFrameId(frame_id));
+  shard.free_list_.push_back(frame_id);
+  DeallocatePage(page_id);
+  return true;
 }
 
 /**
  * TODO: Student Implement
  */
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  Shard &shard = GetShard(page_id);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto page_table_iter = shard.page_table_.find(page_id);
+  if (page_table_iter == shard.page_table_.end()) {
+    return false;
+  }
+  frame_id_t frame_id = page_table_iter->second;
+  Page *page = &pages_[frame_id];
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  page->pin_count_--;
+  if (is_dirty && !page->IsDirty()) {
+    page->is_dirty_ = true;
+    shard.stats_.dirty_pages_++;
+  }
+  if (page->GetPinCount() == 0) {
+    shard.replacer_->Unpin(ToLocalFrameId(frame_id));
+  }
+  return true;
+}
 
-    std::lock_guard<std::recursive_mutex> guard(latch_); // 保护共享数据结构
-
-    auto page_table_iter = page_table_.find(page_id);
-    if (page_table_iter == page_table_.end()) {
-      
-        return false;
+/**
+ * TODO: Student Implement
+ */
+bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  Shard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto page_table_iter = shard.page_table_.find(page_id);
+  if (page_table_iter == shard.page_table_.end()) {
+    return false;
+  }
+  // a flush that is already running may have started before the last change, the page is looked up again after it as
+  // its frame may be retired meanwhile
+  while (pages_[page_table_iter->second].flushing_) {
+    pages_[page_table_iter->second].io_done_.wait(lock);
+    page_table_iter = shard.page_table_.find(page_id);
+    if (page_table_iter == shard.page_table_.end()) {
+      return true;
     }
-    frame_id_t frame_id_to_unpin = page_table_iter->second;
-    Page* page_to_unpin_ptr = &pages_[frame_id_to_unpin];
-    if (page_to_unpin_ptr->GetPinCount() <= 0) {
+  }
+  if (pages_[page_table_iter->second].IsDirty()) {
+    WriteBack(shard, lock, page_table_iter->second);
+  }
+  return true;
+}
 
-        return false; 
+void BufferPoolManager::FlushAllPages() {
+  for (size_t i = 0; i < num_instances_; i++) {
+    Shard &shard = shards_[i];
+    std::vector<page_id_t> dirty_pages;
+    {
+      std::lock_guard<std::mutex> guard(shard.latch_);
+      for (auto &entry : shard.page_table_) {
+        if (pages_[entry.second].IsDirty() || pages_[entry.second].flushing_) {
+          dirty_pages.push_back(entry.first);
+        }
+      }
+      for (auto &entry : shard.evicting_) {
+        dirty_pages.push_back(entry.first);
+      }
     }
-    page_to_unpin_ptr->pin_count_--; 
-    if (is_dirty) {
-        page_to_unpin_ptr->is_dirty_ = true;
-  
+    for (auto page_id : dirty_pages) {
+      std::unique_lock<std::mutex> lock(shard.latch_);
+      auto evicting_iter = shard.evicting_.find(page_id);
+      if (evicting_iter != shard.evicting_.end()) {
+        // the page is being written back by its eviction
+        Page *writer = &pages_[evicting_iter->second];
+        writer->io_done_.wait(lock, [&shard, page_id] { return shard.evicting_.count(page_id) == 0; });
+        continue;
+      }
+      lock.unlock();
+      FlushPage(page_id);
     }
+  }
+  disk_manager_->FlushMetadata();
+  disk_manager_->Sync();
+}
 
-    if (page_to_unpin_ptr->GetPinCount() == 0) {
-        replacer_->Unpin(frame_id_to_unpin);
-       
-    }
+void BufferPoolManager::WriteBack(Shard &shard, unique_lock<mutex> &lock, frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  BeginWriteBack(shard, frame_id);
+  lock.unlock();
+  // the page may be changed by its users meanwhile, they mark it dirty again
+  disk_manager_->WritePage(page->page_id_, page->GetData());
+  lock.lock();
+  EndWriteBack(shard, frame_id);
+}
 
-    return true;
+void BufferPoolManager::BeginWriteBack(Shard &shard, frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  page->pin_count_++;
+  page->flushing_ = true;
+  page->is_dirty_ = false;
+  shard.stats_.dirty_pages_--;
 }
 
-/**
- * TODO: Student Implement
- */
-bool BufferPoolManager::FlushPage(page_id_t page_id) {
-  std::lock_guard<std::recursive_mutex> guard(latch_);
+void BufferPoolManager::EndWriteBack(Shard &shard, frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  page->flushing_ = false;
+  page->io_done_.notify_all();
+  if (--page->pin_count_ == 0) {
+    shard.replacer_->Unpin(ToLocalFrameId(frame_id));
+  }
+}
 
-    auto page_table_iter = page_table_.find(page_id);
-    if (page_table_iter == page_table_.end()) {
-    
-        return false;
+void BufferPoolManager::BackgroundWriter() {
+  std::unique_lock<std::mutex> lock(bg_writer_latch_);
+  while (true) {
+    bg_writer_cv_.wait_for(lock, std::chrono::milliseconds(BG_WRITER_INTERVAL_MS), [this] { return bg_writer_stop_; });
+    if (bg_writer_stop_) {
+      return;
     }
+    lock.unlock();
+    // visit the shards in turn until enough pages are picked or a whole turn finds nothing to write
+    std::vector<frame_id_t> frames;
+    size_t idle_shards = 0;
+    for (size_t i = 0; frames.size() < BG_WRITER_MAX_PAGES && idle_shards < num_instances_ &&
+                       GetStats().dirty_pages_ > static_cast<uint64_t>(dirty_ratio_threshold_ * pool_size_);
+         i = (i + 1) % num_instances_) {
+      frame_id_t frame_id = PickWriteBack(shards_[i]);
+      if (frame_id != INVALID_FRAME_ID) {
+        frames.push_back(frame_id);
+        idle_shards = 0;
+      } else {
+        idle_shards++;
+      }
+    }
+    // write the round's pages at once, the disk manager completes them in any order
+    std::mutex done_latch;
+    std::condition_variable done_cv;
+    size_t pending = frames.size();
+    for (auto frame_id : frames) {
+      Page *page = &pages_[frame_id];
+      disk_manager_->SubmitWrite(page->page_id_, page->GetData(), [&, frame_id](bool) {
+        Shard &shard = shards_[frame_id % num_instances_];
+        {
+          std::lock_guard<std::mutex> guard(shard.latch_);
+          EndWriteBack(shard, frame_id);
+          shard.stats_.background_writes_++;
+        }
+        std::lock_guard<std::mutex> guard(done_latch);
+        if (--pending == 0) {
+          done_cv.notify_all();
+        }
+      });
+    }
+    {
+      std::unique_lock<std::mutex> done_lock(done_latch);
+      done_cv.wait(done_lock, [&pending] { return pending == 0; });
+    }
+    lock.lock();
+  }
+}
 
-    frame_id_t frame_id_to_flush = page_table_iter->second;
-    Page* page_to_flush_ptr = &pages_[frame_id_to_flush];
-
-    if (page_to_flush_ptr->IsDirty()) {
-      
-        disk_manager_->WritePage(page_id, page_to_flush_ptr->GetData());
-    
-        page_to_flush_ptr->is_dirty_ = false;
-      
-    } 
-    return true;
+frame_id_t BufferPoolManager::PickWriteBack(Shard &shard) {
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  for (size_t i = 0; i < shard.size_; i++) {
+    frame_id_t frame_id = ToFrameId(shard, static_cast<frame_id_t>(shard.writer_cursor_));
+    shard.writer_cursor_ = (shard.writer_cursor_ + 1) % shard.size_;
+    Page *page = &pages_[frame_id];
+    if (page->IsDirty() && page->pin_count_ == 0) {
+      BeginWriteBack(shard, frame_id);
+      return frame_id;
+    }
+  }
+  return INVALID_FRAME_ID;
 }
 
 page_id_t BufferPoolManager::AllocatePage() {
@@ -239,14 +564,143 @@ bool BufferPoolManager::IsPageFree(page_id_t page_id) {
   return disk_manager_->IsPageFree(page_id);
 }
 
+void BufferPoolManager::PrepareStrategy(BufferAccessStrategy *strategy) {
+  if (strategy == nullptr) {
+    return;
+  }
+  ASSERT(strategy->buffer_pool_manager_ == nullptr || strategy->buffer_pool_manager_ == this,
+         "A buffer access strategy is used with two buffer pools.");
+  strategy->buffer_pool_manager_ = this;
+  if (strategy->GetType() != AccessStrategyType::NORMAL && strategy->rings_.size() != num_instances_) {
+    strategy->rings_.assign(num_instances_, BufferAccessStrategy::Ring());
+  }
+}
+
+void BufferPoolManager::Prefetch(page_id_t page_id, NextPageFunc next_page, BufferAccessStrategy *strategy) {
+  if (page_id == INVALID_PAGE_ID || prefetch_window_ == 0) {
+    return;
+  }
+  PrepareStrategy(strategy);
+  std::lock_guard<std::mutex> guard(prefetch_latch_);
+  if (!prefetch_worker_.joinable()) {
+    prefetch_worker_ = std::thread(&BufferPoolManager::PrefetchWorker, this);
+  }
+  if (!prefetch_queue_.empty() && prefetch_queue_.back().next_page_ == next_page &&
+      prefetch_queue_.back().strategy_ == strategy) {
+    prefetch_queue_.back().page_id_ = page_id;
+  } else {
+    prefetch_queue_.push_back({page_id, next_page, strategy});
+  }
+  prefetch_cv_.notify_all();
+}
+
+void BufferPoolManager::CancelPrefetch(BufferAccessStrategy *strategy) {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  for (auto iter = prefetch_queue_.begin(); iter != prefetch_queue_.end();) {
+    iter = iter->strategy_ == strategy ? prefetch_queue_.erase(iter) : std::next(iter);
+  }
+  prefetch_cv_.wait(lock, [this, strategy] { return !prefetch_running_ || prefetch_active_ != strategy; });
+}
+
+void BufferPoolManager::PrefetchWorker() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return prefetch_stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_stop_) {
+      return;
+    }
+    PrefetchRequest request = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    prefetch_active_ = request.strategy_;
+    prefetch_running_ = true;
+    lock.unlock();
+    ReadAhead(request);
+    lock.lock();
+    prefetch_running_ = false;
+    prefetch_active_ = nullptr;
+    prefetch_cv_.notify_all();
+  }
+}
+
+void BufferPoolManager::ReadAhead(const PrefetchRequest &request) {
+  page_id_t page_id = request.page_id_;
+  for (size_t i = 0; i < prefetch_window_ && page_id != INVALID_PAGE_ID; i++) {
+    Shard &shard = GetShard(page_id);
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    frame_id_t frame_id;
+    auto page_table_iter = shard.page_table_.find(page_id);
+    if (page_table_iter != shard.page_table_.end()) {
+      frame_id = page_table_iter->second;
+      // the rest of the chain is not known before somebody else's read completes
+      if (pages_[frame_id].io_pending_ || request.next_page_ == nullptr) {
+        break;
+      }
+      // pinned to follow the chain but no access, like a write-back
+      pages_[frame_id].pin_count_++;
+    } else {
+      if (shard.evicting_.count(page_id) != 0) {
+        break;
+      }
+      page_id_t evicted_page_id;
+      frame_id = TryToFindFreePage(shard, page_id, evicted_page_id, request.strategy_);
+      if (frame_id == INVALID_FRAME_ID) {
+        break;
+      }
+      // the frame is pinned while it is read but the read is no access, the replacer only learns about it on unpin
+      Page *page = &pages_[frame_id];
+      page->page_id_ = page_id;
+      page->pin_count_ = 1;
+      page->is_dirty_ = false;
+      page->prefetched_ = true;
+      shard.page_table_[page_id] = frame_id;
+      shard.stats_.prefetches_++;
+      if (!LoadFrame(shard, lock, frame_id, evicted_page_id, true)) {
+        break;
+      }
+    }
+    Page *page = &pages_[frame_id];
+    page_id = INVALID_PAGE_ID;
+    if (request.next_page_ != nullptr) {
+      // the page is changed under its latch by users that may wait for the shard latch meanwhile, e.g. to append a
+      // page to the chain, so the page latch is taken without the shard latch
+      lock.unlock();
+      page->RLatch();
+      page_id = request.next_page_(page);
+      page->RUnlatch();
+      lock.lock();
+    }
+    if (--page->pin_count_ == 0) {
+      shard.replacer_->Unpin(ToLocalFrameId(frame_id));
+    }
+  }
+}
+
+BufferPoolStats BufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (size_t i = 0; i < num_instances_; i++) {
+    std::lock_guard<std::mutex> guard(shards_[i].latch_);
+    stats.hits_ += shards_[i].stats_.hits_;
+    stats.misses_ += shards_[i].stats_.misses_;
+    stats.prefetches_ += shards_[i].stats_.prefetches_;
+    stats.prefetch_hits_ += shards_[i].stats_.prefetch_hits_;
+    stats.background_writes_ += shards_[i].stats_.background_writes_;
+    stats.dirty_pages_ += shards_[i].stats_.dirty_pages_;
+  }
+  return stats;
+}
+
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
   bool res = true;
-  for (size_t i = 0; i < pool_size_; i++) {
-    if (pages_[i].pin_count_ != 0) {
-      res = false;
-      LOG(ERROR) << "page " << pages_[i].page_id_ << " pin count:" << pages_[i].pin_count_ << endl;
+  for (size_t i = 0; i < num_instances_; i++) {
+    std::lock_guard<std::mutex> guard(shards_[i].latch_);
+    for (size_t local_frame_id = 0; local_frame_id < shards_[i].size_; local_frame_id++) {
+      Page *page = &pages_[ToFrameId(shards_[i], static_cast<frame_id_t>(local_frame_id))];
+      if (page->pin_count_ != 0) {
+        res = false;
+        LOG(ERROR) << "page " << page->page_id_ << " pin count:" << page->pin_count_ << endl;
+      }
     }
   }
   return res;
-}
\ No newline at end of file
+}
@@ -0,0 +1,63 @@
+#include "buffer/clock_replacer.h"
+
+#include "common/macros.h"
+
+CLOCKReplacer::CLOCKReplacer(size_t num_pages) : capacity_(num_pages), states_(new atomic<uint8_t>[num_pages]) {
+  for (size_t i = 0; i < capacity_; i++) {
+    states_[i].store(0, memory_order_relaxed);
+  }
+}
+
+CLOCKReplacer::~CLOCKReplacer() = default;
+
+bool CLOCKReplacer::Victim(frame_id_t *frame_id) {
+  // every evictable frame has its reference bit cleared within one revolution, so two revolutions find a victim
+  // unless other threads keep pinning and unpinning concurrently
+  for (size_t step = 0; step < 2 * capacity_ + 1 && size_.load() > 0; step++) {
+    size_t slot = hand_.fetch_add(1) % capacity_;
+    uint8_t state = states_[slot].load();
+    if ((state & EVICTABLE) == 0) {
+      continue;
+    }
+    if ((state & REFERENCED) != 0) {
+      states_[slot].compare_exchange_strong(state, static_cast<uint8_t>(state & ~REFERENCED));
+      continue;
+    }
+    if (states_[slot].compare_exchange_strong(state, static_cast<uint8_t>(0))) {
+      size_--;
+      if (frame_id != nullptr) {
+        *frame_id = static_cast<frame_id_t>(slot);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void CLOCKReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  if ((states_[frame_id].fetch_and(static_cast<uint8_t>(~EVICTABLE)) & EVICTABLE) != 0) {
+    size_--;
+  }
+}
+
+void CLOCKReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  if ((states_[frame_id].fetch_or(EVICTABLE | REFERENCED) & EVICTABLE) == 0) {
+    size_++;
+  }
+}
+
+size_t CLOCKReplacer::Size() { return size_.load(); }
+
+void CLOCKReplacer::Resize(size_t num_pages) {
+  unique_ptr<atomic<uint8_t>[]> states(new atomic<uint8_t>[num_pages]);
+  for (size_t i = 0; i < num_pages; i++) {
+    states[i].store(i < capacity_ ? states_[i].load() : 0, memory_order_relaxed);
+  }
+  for (size_t i = num_pages; i < capacity_; i++) {
+    ASSERT((states_[i].load() & EVICTABLE) == 0, "Evictable frame dropped.");
+  }
+  states_ = std::move(states);
+  capacity_ = num_pages;
+}
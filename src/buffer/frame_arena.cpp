@@ -0,0 +1,47 @@
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(size_t num_frames) : num_frames_(num_frames) {
+  size_ = std::max<size_t>(1, (num_frames_ * PAGE_SIZE + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+#ifdef MAP_HUGETLB
+  // explicit huge pages are reserved by the mapping, it fails at once if there are not enough of them
+  void *huge = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (huge != MAP_FAILED) {
+    mapping_ = data_ = static_cast<char *>(huge);
+    mapping_size_ = size_;
+    huge_tlb_ = true;
+    return;
+  }
+#endif
+  // normal pages, with a huge page more mapped to align the arena to one
+  mapping_size_ = size_ + HUGE_PAGE_SIZE;
+  void *mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                       -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  mapping_ = static_cast<char *>(mapping);
+  auto address = reinterpret_cast<uintptr_t>(mapping_);
+  data_ = reinterpret_cast<char *>((address + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+#ifdef MADV_HUGEPAGE
+  madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+FrameArena::~FrameArena() { munmap(mapping_, mapping_size_); }
+
+void FrameArena::Release(size_t begin, size_t end) {
+  size_t granularity = huge_tlb_ ? HUGE_PAGE_SIZE : std::max<size_t>(PAGE_SIZE, sysconf(_SC_PAGESIZE));
+  size_t begin_offset = (begin * PAGE_SIZE + granularity - 1) / granularity * granularity;
+  // the arena is mapped to a whole huge page, the part behind the last frame goes along with it
+  size_t end_offset = (end >= num_frames_ ? size_ : end * PAGE_SIZE) / granularity * granularity;
+  if (begin_offset < end_offset) {
+    madvise(data_ + begin_offset, end_offset - begin_offset, MADV_DONTNEED);
+  }
+}
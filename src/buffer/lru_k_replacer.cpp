@@ -0,0 +1,115 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_period)
+    : capacity_(num_pages),
+      k_(k == 0 ? 1 : k),
+      correlated_period_(correlated_period),
+      history_(num_pages * k_, 0),
+      last_access_(num_pages, 0),
+      access_count_(num_pages, 0),
+      evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+LRUKReplacer::EvictKey LRUKReplacer::GetEvictKey(frame_id_t frame_id) {
+  if (access_count_[frame_id] < k_) {
+    return {false, last_access_[frame_id], frame_id};
+  }
+  return {true, History(frame_id, k_ - 1), frame_id};
+}
+
+void LRUKReplacer::Forget(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evictable_set_.erase(GetEvictKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  access_count_[frame_id] = 0;
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (evictable_set_.empty()) {
+    return false;
+  }
+  frame_id_t victim = std::get<2>(*evictable_set_.begin());
+  for (const auto &key : evictable_set_) {
+    frame_id_t candidate = std::get<2>(key);
+    if (current_timestamp_ - last_access_[candidate] > correlated_period_) {
+      victim = candidate;
+      break;
+    }
+  }
+  Forget(victim);
+  if (frame_id != nullptr) {
+    *frame_id = victim;
+  }
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  std::lock_guard<std::mutex> guard(latch_);
+  if (evictable_[frame_id]) {
+    evictable_set_.erase(GetEvictKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  uint64_t now = ++current_timestamp_;
+  if (access_count_[frame_id] == 0) {
+    History(frame_id, 0) = now;
+    access_count_[frame_id] = 1;
+  } else if (now - last_access_[frame_id] > correlated_period_) {
+    // a new uncorrelated access, the older ones are shifted by the length of the correlated period that just closed
+    uint64_t correlated_length = last_access_[frame_id] - History(frame_id, 0);
+    for (size_t i = k_ - 1; i > 0; i--) {
+      History(frame_id, i) = History(frame_id, i - 1) + correlated_length;
+    }
+    History(frame_id, 0) = now;
+    if (access_count_[frame_id] < k_) {
+      access_count_[frame_id]++;
+    }
+  }
+  last_access_[frame_id] = now;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  std::lock_guard<std::mutex> guard(latch_);
+  if (!evictable_[frame_id]) {
+    if (access_count_[frame_id] == 0) {
+      // a frame filled without being accessed (read ahead) is ordered by the time it became evictable
+      last_access_[frame_id] = current_timestamp_;
+    }
+    evictable_[frame_id] = true;
+    evictable_set_.insert(GetEvictKey(frame_id));
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  std::lock_guard<std::mutex> guard(latch_);
+  Forget(frame_id);
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return evictable_set_.size();
+}
+
+void LRUKReplacer::Resize(size_t num_pages) {
+  std::lock_guard<std::mutex> guard(latch_);
+  for (size_t i = num_pages; i < capacity_; i++) {
+    ASSERT(!evictable_[i], "Evictable frame dropped.");
+  }
+  capacity_ = num_pages;
+  history_.resize(num_pages * k_, 0);
+  last_access_.resize(num_pages, 0);
+  access_count_.resize(num_pages, 0);
+  evictable_.resize(num_pages, false);
+  // a shrunk replacer gives its memory back
+  history_.shrink_to_fit();
+  last_access_.shrink_to_fit();
+  access_count_.shrink_to_fit();
+  evictable_.shrink_to_fit();
+}
@@ -1,78 +1,75 @@
 #include "buffer/lru_replacer.h"
+
+#include "common/macros.h"
 #include "glog/logging.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages):capacity_(num_pages){}
+LRUReplacer::LRUReplacer(size_t num_pages) : nodes_(num_pages + 1), capacity_(num_pages) {
+  for (auto &node : nodes_) {
+    node = {INVALID_FRAME_ID, INVALID_FRAME_ID, false};
+  }
+  frame_id_t head = static_cast<frame_id_t>(capacity_);
+  nodes_[head].prev_ = head;
+  nodes_[head].next_ = head;
+}
 
 LRUReplacer::~LRUReplacer() = default;
 
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  Node &node = nodes_[frame_id];
+  nodes_[node.prev_].next_ = node.next_;
+  nodes_[node.next_].prev_ = node.prev_;
+  node.in_list_ = false;
+  size_--;
+}
+
+void LRUReplacer::PushFront(frame_id_t frame_id) {
+  frame_id_t head = static_cast<frame_id_t>(capacity_);
+  Node &node = nodes_[frame_id];
+  node.prev_ = head;
+  node.next_ = nodes_[head].next_;
+  nodes_[node.next_].prev_ = frame_id;
+  nodes_[head].next_ = frame_id;
+  node.in_list_ = true;
+  size_++;
+}
+
 /**
  * TODO: Student Implement
  */
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
-
-    if (lru_list_.empty()) {
-        
-        if (frame_id != nullptr) {
-            // *frame_id = INVALID_FRAME_ID; // 可选
-        }
-        return false;
-    }
-
-    // 获取LRU元素 (链表尾部)
-    frame_id_t victim_id = lru_list_.back();
-
-    // 从链表中移除
-    lru_list_.pop_back(); // O(1)
-    
-    // 从set中也移除
-    size_t erased_from_set = lru_set_tracker_.erase(victim_id); 
-
-
-    if (frame_id != nullptr) {
-        *frame_id = victim_id;
-    }
-
-    return true;
+  if (size_ == 0) {
+    return false;
+  }
+  frame_id_t victim = nodes_[capacity_].prev_;
+  Unlink(victim);
+  if (frame_id != nullptr) {
+    *frame_id = victim;
+  }
+  return true;
 }
 
 /**
  * TODO: Student Implement
  */
 void LRUReplacer::Pin(frame_id_t frame_id) {
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
   std::lock_guard<std::mutex> guard(latch_);
-    if (lru_set_tracker_.count(frame_id)) { 
-
-        lru_set_tracker_.erase(frame_id);
-
-        lru_list_.remove(frame_id); 
-
-    } else {
-
-    }
+  if (nodes_[frame_id].in_list_) {
+    Unlink(frame_id);
+  }
 }
 
 /**
  * TODO: Student Implement
  */
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-   std::lock_guard<std::mutex> guard(latch_);
-
-    if (lru_set_tracker_.find(frame_id) == lru_set_tracker_.end()) { // 不在集合中
-        
-        if (lru_list_.size() >= capacity_) {
-            if (capacity_ == 0) {
-                 
-                return;
-            }
-
-        }
-        lru_list_.push_front(frame_id); // 加到MRU端 (list头部)
-        lru_set_tracker_.insert(frame_id); // 加入set
-       
-    } else {
-        
-    }
+  ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "Frame id out of range.");
+  std::lock_guard<std::mutex> guard(latch_);
+  // unpinning a frame that is already evictable keeps its position
+  if (!nodes_[frame_id].in_list_) {
+    PushFront(frame_id);
+  }
 }
 
 /**
@@ -80,14 +77,26 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
  */
 size_t LRUReplacer::Size() {
   std::lock_guard<std::mutex> guard(latch_);
-    // 返回当前在可替换列表中的元素数量
-    size_t current_size = lru_list_.size();
-    // 验证与 set 大小的一致性 (用于调试)
-    if (current_size != lru_set_tracker_.size()) {
-        LOG(ERROR) << "LRUReplacer::Size: Mismatch between lru_list_ size (" << current_size
-                   << ") and lru_set_tracker_ size (" << lru_set_tracker_.size() << "). Data inconsistency!";
-    }
-    // LOG(INFO) << "LRUReplacer::Size: Current number of evictable frames is " << current_size;
-    return current_size;
+  return size_;
+}
 
-}
\ No newline at end of file
+void LRUReplacer::Resize(size_t num_pages) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // the list moves with the head, which is the last node
+  std::vector<frame_id_t> order;
+  order.reserve(size_);
+  for (frame_id_t frame_id = nodes_[capacity_].next_; frame_id != static_cast<frame_id_t>(capacity_);
+       frame_id = nodes_[frame_id].next_) {
+    ASSERT(static_cast<size_t>(frame_id) < num_pages, "Evictable frame dropped.");
+    order.push_back(frame_id);
+  }
+  nodes_ = std::vector<Node>(num_pages + 1, {INVALID_FRAME_ID, INVALID_FRAME_ID, false});
+  capacity_ = num_pages;
+  frame_id_t head = static_cast<frame_id_t>(capacity_);
+  nodes_[head].prev_ = head;
+  nodes_[head].next_ = head;
+  size_ = 0;
+  for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+    PushFront(*iter);
+  }
+}
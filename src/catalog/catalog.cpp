@@ -1,7 +1,7 @@
 #include "catalog/catalog.h"
 
 void CatalogMeta::SerializeTo(char *buf) const {
-  ASSERT(GetSerializedSize() <= PAGE_SIZE, "Failed to serialize catalog metadata to disk.");
+  ASSERT(GetSerializedSize() <= PAGE_SIZE - PAGE_CHECKSUM_SIZE, "Failed to serialize catalog metadata to disk.");
   MACH_WRITE_UINT32(buf, CATALOG_METADATA_MAGIC_NUM);
   buf += 4;
   MACH_WRITE_UINT32(buf, table_meta_pages_.size());
@@ -139,7 +139,10 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
 }
 
 CatalogManager::~CatalogManager() {
-  FlushCatalogMetaPage();
+  // a read-only database has nothing to write back
+  if (!buffer_pool_manager_->IsReadOnly()) {
+    FlushCatalogMetaPage();
+  }
   delete catalog_meta_;
   for (auto iter : tables_) {
     delete iter.second;
@@ -184,12 +187,18 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     return DB_FAILED; // Schema copy failed
   }
 
+  // Create the free-space map of the table heap, it records the root page
+  page_id_t fsm_page_id =
+      FreeSpaceMap::Create(buffer_pool_manager_, table_heap_root_id, table_heap_root_page_obj->GetFreeSpaceRemaining());
+
   // Create table metadata
-  TableMetadata *table_meta = TableMetadata::Create(new_table_id, table_name, table_heap_root_id, tmp_schema);
+  TableMetadata *table_meta =
+      TableMetadata::Create(new_table_id, table_name, table_heap_root_id, fsm_page_id, tmp_schema);
   if (table_meta == nullptr) {
     delete tmp_schema;
     buffer_pool_manager_->UnpinPage(table_heap_root_id, false); // Page was inited but op failed before table fully formed
     buffer_pool_manager_->DeletePage(table_heap_root_id);
+    buffer_pool_manager_->DeletePage(fsm_page_id);
     return DB_FAILED; // TableMetadata creation failed
   }
 
@@ -200,6 +209,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     delete table_meta; // table_meta owns tmp_schema
     buffer_pool_manager_->UnpinPage(table_heap_root_id, false); 
     buffer_pool_manager_->DeletePage(table_heap_root_id);
+    buffer_pool_manager_->DeletePage(fsm_page_id);
     return DB_FAILED; 
   }
 
@@ -210,13 +220,15 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
   // Create the table heap
   TableHeap *table_heap_obj = nullptr; 
   try {
-    table_heap_obj = TableHeap::Create(buffer_pool_manager_, table_heap_root_id, table_meta->GetSchema(), log_manager_, lock_manager_);
+    table_heap_obj = TableHeap::Create(buffer_pool_manager_, table_heap_root_id, fsm_page_id, table_meta->GetSchema(),
+                                       log_manager_, lock_manager_);
   } catch (const std::bad_alloc &) {
     buffer_pool_manager_->UnpinPage(meta_page_id, false); // Not dirty from this failure's perspective
     buffer_pool_manager_->DeletePage(meta_page_id);
     delete table_meta; // owns tmp_schema
     buffer_pool_manager_->UnpinPage(table_heap_root_id, true); 
     buffer_pool_manager_->DeletePage(table_heap_root_id);
+    buffer_pool_manager_->DeletePage(fsm_page_id);
     return DB_FAILED;
   }
 
@@ -234,6 +246,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     delete table_meta; // owns tmp_schema
     buffer_pool_manager_->UnpinPage(table_heap_root_id, true); // Dirty from Init
     buffer_pool_manager_->DeletePage(table_heap_root_id);
+    buffer_pool_manager_->DeletePage(fsm_page_id);
     return DB_FAILED;
   }
 
@@ -254,6 +267,7 @@ dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schem
     buffer_pool_manager_->DeletePage(meta_page_id);
     buffer_pool_manager_->UnpinPage(table_heap_root_id, true); // Dirty from Init
     buffer_pool_manager_->DeletePage(table_heap_root_id);
+    buffer_pool_manager_->DeletePage(fsm_page_id);
     return DB_FAILED;
   }
 
@@ -832,7 +846,8 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   page_id_t table_heap_root_page_id = table_meta->GetFirstPageId();
   TableHeap *table_heap = nullptr;
   try {
-    table_heap = TableHeap::Create(buffer_pool_manager_, table_heap_root_page_id, table_schema, log_manager_, lock_manager_);
+    table_heap = TableHeap::Create(buffer_pool_manager_, table_heap_root_page_id, table_meta->GetFreeSpaceMapPageId(),
+                                   table_schema, log_manager_, lock_manager_);
   } catch (const std::bad_alloc &e) {
     LOG(ERROR) << "Failed to allocate TableHeap for table_id " << table_id << ": " << e.what();
     delete table_meta; // table_meta 尚未被 TableInfo 接管
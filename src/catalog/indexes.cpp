@@ -12,7 +12,7 @@ IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &in
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
   char *p = buf;
   uint32_t ofs = GetSerializedSize();
-  ASSERT(ofs <= PAGE_SIZE, "Failed to serialize index info.");
+  ASSERT(ofs <= PAGE_SIZE - PAGE_CHECKSUM_SIZE, "Failed to serialize index info.");
   // magic num
   MACH_WRITE_UINT32(buf, INDEX_METADATA_MAGIC_NUM);
   buf += 4;
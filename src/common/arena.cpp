@@ -0,0 +1,51 @@
+#include "common/arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+Arena::~Arena() {
+  for (auto &block : blocks_) {
+    delete[] block.data_;
+  }
+}
+
+size_t Arena::GetCapacity() const {
+  size_t capacity = INLINE_BLOCK_SIZE;
+  for (auto &block : blocks_) {
+    capacity += block.size_;
+  }
+  return capacity;
+}
+
+/** @return the offset of the first byte from offset on in the block that is aligned */
+static size_t AlignOffset(const char *data, size_t offset, size_t alignment) {
+  auto base = reinterpret_cast<uintptr_t>(data);
+  return ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+}
+
+void *Arena::do_allocate(size_t bytes, size_t alignment) {
+  Block block = GetBlock(block_);
+  size_t offset = AlignOffset(block.data_, offset_, alignment);
+  if (offset + bytes > block.size_) {
+    NextBlock(bytes, alignment);
+    block = GetBlock(block_);
+    offset = AlignOffset(block.data_, 0, alignment);
+  }
+  offset_ = offset + bytes;
+  return block.data_ + offset;
+}
+
+void Arena::NextBlock(size_t bytes, size_t alignment) {
+  size_t size = bytes + alignment;
+  offset_ = 0;
+  // blocks left behind by a rewind are used again
+  while (block_ < blocks_.size()) {
+    block_++;
+    if (GetBlock(block_).size_ >= size) {
+      return;
+    }
+  }
+  size = std::max(size, BLOCK_SIZE);
+  blocks_.push_back({new char[size], size});
+  block_ = blocks_.size();
+}
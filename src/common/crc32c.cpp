@@ -0,0 +1,88 @@
+#include "common/crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82f63b78;  // reversed Castagnoli polynomial
+
+struct Crc32cTable {
+  uint32_t entries_[8][256];
+
+  constexpr Crc32cTable() : entries_() {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+      }
+      entries_[0][i] = crc;
+    }
+    // entries_[k][i] is the checksum of byte i followed by k zero bytes, to process 8 bytes per step
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int k = 1; k < 8; k++) {
+        entries_[k][i] = (entries_[k - 1][i] >> 8) ^ entries_[0][entries_[k - 1][i] & 0xff];
+      }
+    }
+  }
+};
+
+constexpr Crc32cTable kTable;
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t Crc32cHardware(const char *data, size_t len, uint32_t crc) {
+  uint64_t crc64 = ~crc;
+  for (; len >= sizeof(uint64_t); data += sizeof(uint64_t), len -= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  auto crc32 = static_cast<uint32_t>(crc64);
+  for (; len > 0; data++, len--) {
+    crc32 = _mm_crc32_u8(crc32, static_cast<uint8_t>(*data));
+  }
+  return ~crc32;
+}
+
+bool DetectSse42() {
+  // runs during static initialization, before the CPU model is set up otherwise
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2");
+}
+
+const bool kHasSse42 = DetectSse42();
+#else
+const bool kHasSse42 = false;
+#endif
+
+}  // namespace
+
+uint32_t Crc32cSoftware(const char *data, size_t len, uint32_t crc) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(data);
+  crc = ~crc;
+  // slicing-by-8, the table lookups of the 8 bytes are independent
+  for (; len >= 8; bytes += 8, len -= 8) {
+    uint32_t low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+    crc = kTable.entries_[7][low & 0xff] ^ kTable.entries_[6][(low >> 8) & 0xff] ^
+          kTable.entries_[5][(low >> 16) & 0xff] ^ kTable.entries_[4][low >> 24] ^ kTable.entries_[3][bytes[4]] ^
+          kTable.entries_[2][bytes[5]] ^ kTable.entries_[1][bytes[6]] ^ kTable.entries_[0][bytes[7]];
+  }
+  for (; len > 0; bytes++, len--) {
+    crc = (crc >> 8) ^ kTable.entries_[0][(crc ^ *bytes) & 0xff];
+  }
+  return ~crc;
+}
+
+uint32_t Crc32c(const char *data, size_t len, uint32_t crc) {
+#if defined(__x86_64__)
+  if (kHasSse42) {
+    return Crc32cHardware(data, len, crc);
+  }
+#endif
+  return Crc32cSoftware(data, len, crc);
+}
+
+bool Crc32cIsHardware() { return kHasSse42; }
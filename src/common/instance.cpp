@@ -3,16 +3,25 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size,
+                                 uint32_t buffer_pool_instances, ReplacerType replacer_type, bool read_only,
+                                 uint32_t max_buffer_pool_size)
     : db_file_name_(std::move(db_name)), init_(init) {
+  if (init_ && read_only) {
+    throw logic_error("Can not initialize a read-only database.");
+  }
   // Init database file if needed
   db_file_name_ = "./databases/" + db_file_name_;
   if (init_) {
     remove(db_file_name_.c_str());
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
-  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  disk_mgr_ = new DiskManager(db_file_name_, DiskIOBackendType::IO_URING, read_only);
+  if (disk_mgr_->GetRepairedPages() > 0) {
+    LOG(WARNING) << "Repaired " << disk_mgr_->GetRepairedPages() << " torn pages of " << db_file_name_
+                 << " from the double-write area";
+  }
+  bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_, buffer_pool_instances, replacer_type, max_buffer_pool_size);
 
   // Allocate static page for db storage engine
   if (init) {
@@ -0,0 +1,504 @@
+#include "executor/copy_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+#include "common/macros.h"
+
+/**
+ * A piece of the file parsed by one worker: the text of whole lines, or one block of a binary file.
+ */
+struct CopyLoader::Segment {
+  const char *begin_;
+  const char *end_;
+  // rows in a binary block
+  uint32_t row_count_{0};
+  RowBatch batch_;
+  // index keys of the rows in the batch, one vector per index
+  std::vector<std::vector<Row>> keys_;
+  // lines or rows read, the last one is where the error is
+  uint32_t read_{0};
+  std::string error_;
+  bool parsed_{false};
+
+  Segment(const char *begin, const char *end, uint32_t row_count = 0)
+      : begin_(begin), end_(end), row_count_(row_count) {}
+};
+
+CopyLoader::CopyLoader(ExecuteContext *exec_ctx, TableInfo *table_info, std::vector<IndexInfo *> indexes,
+                       uint32_t workers)
+    : exec_ctx_(exec_ctx),
+      table_info_(table_info),
+      schema_(table_info->GetSchema()),
+      indexes_(std::move(indexes)),
+      workers_(workers != 0 ? workers : std::max(1u, std::thread::hardware_concurrency())) {
+  key_index_names_.resize(schema_->GetColumnCount());
+  for (auto index_info : indexes_) {
+    std::vector<uint32_t> key_map;
+    for (auto column : index_info->GetIndexKeySchema()->GetColumns()) {
+      uint32_t column_index;
+      schema_->GetColumnIndex(column->GetName(), column_index);
+      key_map.push_back(column_index);
+      key_index_names_[column_index] = index_info->GetIndexName();
+    }
+    key_maps_.push_back(std::move(key_map));
+  }
+}
+
+dberr_t CopyLoader::Load(const std::string &file_name, CopyFormat format) {
+  format_ = format;
+  row_count_ = 0;
+  error_.clear();
+  keys_.assign(indexes_.size(), {});
+  row_ids_.clear();
+
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error_ = "cannot open file " + file_name + ": " + strerror(errno);
+    return DB_FAILED;
+  }
+  struct stat stat_buf {};
+  if (fstat(fd, &stat_buf) != 0) {
+    error_ = "cannot stat file " + file_name + ": " + strerror(errno);
+    close(fd);
+    return DB_FAILED;
+  }
+  size_t size = stat_buf.st_size;
+  const char *data = nullptr;
+  if (size > 0) {
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      error_ = "cannot map file " + file_name + ": " + strerror(errno);
+      close(fd);
+      return DB_FAILED;
+    }
+    madvise(addr, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(addr);
+  }
+
+  std::vector<Segment> segments;
+  bool split = format == CopyFormat::CSV ? SplitCsv(data, size, segments) : SplitBinary(data, size, segments);
+  dberr_t result = split ? LoadSegments(segments) : DB_FAILED;
+  if (data != nullptr) {
+    munmap(const_cast<char *>(data), size);
+  }
+  close(fd);
+  return result;
+}
+
+void CopyLoader::WriteBinaryHeader(std::ostream &out, const Schema *schema) {
+  char header[sizeof(BINARY_MAGIC) + sizeof(uint32_t)];
+  memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  MACH_WRITE_UINT32(header + sizeof(BINARY_MAGIC), schema->GetColumnCount());
+  out.write(header, sizeof(header));
+}
+
+void CopyLoader::WriteBinaryBlock(std::ostream &out, const std::vector<Row> &rows, Schema *schema) {
+  uint32_t size = 0;
+  for (auto &row : rows) {
+    size += row.GetSerializedSize(schema);
+  }
+  std::vector<char> block(2 * sizeof(uint32_t) + size);
+  MACH_WRITE_UINT32(block.data(), static_cast<uint32_t>(rows.size()));
+  MACH_WRITE_UINT32(block.data() + sizeof(uint32_t), size);
+  char *p = block.data() + 2 * sizeof(uint32_t);
+  for (auto &row : rows) {
+    p += row.SerializeTo(p, schema);
+  }
+  out.write(block.data(), block.size());
+}
+
+bool CopyLoader::SplitCsv(const char *data, size_t size, std::vector<Segment> &segments) {
+  size_t begin = 0;
+  while (begin < size) {
+    // a segment ends after the first line break past its nominal size
+    size_t end = size;
+    if (size - begin > CSV_SEGMENT_SIZE) {
+      auto *line_break = static_cast<const char *>(memchr(data + begin + CSV_SEGMENT_SIZE, '\n',
+                                                          size - begin - CSV_SEGMENT_SIZE));
+      if (line_break != nullptr) {
+        end = line_break - data + 1;
+      }
+    }
+    segments.emplace_back(data + begin, data + end);
+    begin = end;
+  }
+  return true;
+}
+
+bool CopyLoader::SplitBinary(const char *data, size_t size, std::vector<Segment> &segments) {
+  size_t header_size = sizeof(BINARY_MAGIC) + sizeof(uint32_t);
+  if (size < header_size || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+    error_ = "not a binary copy file";
+    return false;
+  }
+  if (MACH_READ_UINT32(data + sizeof(BINARY_MAGIC)) != schema_->GetColumnCount()) {
+    error_ = "the file has " + std::to_string(MACH_READ_UINT32(data + sizeof(BINARY_MAGIC))) +
+             " columns, the table " + std::to_string(schema_->GetColumnCount());
+    return false;
+  }
+  size_t offset = header_size;
+  while (offset < size) {
+    if (size - offset < 2 * sizeof(uint32_t) ||
+        size - offset - 2 * sizeof(uint32_t) < MACH_READ_UINT32(data + offset + sizeof(uint32_t))) {
+      error_ = "block " + std::to_string(segments.size() + 1) + " is truncated";
+      return false;
+    }
+    uint32_t row_count = MACH_READ_UINT32(data + offset);
+    uint32_t block_size = MACH_READ_UINT32(data + offset + sizeof(uint32_t));
+    const char *begin = data + offset + 2 * sizeof(uint32_t);
+    segments.emplace_back(begin, begin + block_size, row_count);
+    offset += 2 * sizeof(uint32_t) + block_size;
+  }
+  return true;
+}
+
+dberr_t CopyLoader::LoadSegments(std::vector<Segment> &segments) {
+  Txn *txn = exec_ctx_->GetTransaction();
+  TableHeap *table_heap = table_info_->GetTableHeap();
+  // a table with rows already may have keys the loaded rows clash with
+  has_rows_ = table_heap->Begin(txn) != table_heap->End();
+  strategy_ = std::make_unique<BufferAccessStrategy>(AccessStrategyType::BULK_WRITE);
+
+  // workers parse the segments in order, at most window ahead of the one being inserted
+  std::mutex latch;
+  std::condition_variable cv;
+  size_t next = 0;
+  size_t inserted = 0;
+  bool stop = false;
+  size_t window = SEGMENTS_IN_FLIGHT * workers_;
+  auto parse = [&]() {
+    while (true) {
+      size_t i;
+      {
+        std::unique_lock<std::mutex> lock(latch);
+        cv.wait(lock, [&] { return stop || next >= segments.size() || next < inserted + window; });
+        if (stop || next >= segments.size()) {
+          return;
+        }
+        i = next++;
+      }
+      ParseSegment(segments[i]);
+      {
+        std::lock_guard<std::mutex> lock(latch);
+        segments[i].parsed_ = true;
+      }
+      cv.notify_all();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < workers_; i++) {
+    threads.emplace_back(parse);
+  }
+
+  bool ok = true;
+  // lines or binary rows before the segment being inserted
+  uint64_t read = 0;
+  for (size_t i = 0; i < segments.size() && ok; i++) {
+    {
+      std::unique_lock<std::mutex> lock(latch);
+      cv.wait(lock, [&] { return segments[i].parsed_; });
+    }
+    Segment &segment = segments[i];
+    if (!segment.error_.empty()) {
+      error_ = (format_ == CopyFormat::CSV ? "line " : "row ") + std::to_string(read + segment.read_) + ": " +
+               segment.error_;
+      ok = false;
+    } else if (!InsertSegment(segment)) {
+      ok = false;
+    }
+    read += segment.read_;
+    // the rows are in the heap and their keys moved out, drop what is left
+    segment.batch_.Clear();
+    segment.keys_.clear();
+    {
+      std::lock_guard<std::mutex> lock(latch);
+      inserted = i + 1;
+      stop = !ok;
+    }
+    cv.notify_all();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  size_t built = 0;
+  if (ok) {
+    for (; built < indexes_.size(); built++) {
+      if (!BuildIndex(built)) {
+        ok = false;
+        break;
+      }
+    }
+  }
+  if (!ok) {
+    Rollback(built);
+    return DB_FAILED;
+  }
+  row_count_ = row_ids_.size();
+  return DB_SUCCESS;
+}
+
+void CopyLoader::ParseSegment(Segment &segment) const {
+  if (format_ == CopyFormat::CSV) {
+    std::vector<Field> fields;
+    fields.reserve(schema_->GetColumnCount());
+    const char *p = segment.begin_;
+    while (p < segment.end_) {
+      auto *line_break = static_cast<const char *>(memchr(p, '\n', segment.end_ - p));
+      const char *end = line_break != nullptr ? line_break : segment.end_;
+      const char *line_end = end > p && end[-1] == '\r' ? end - 1 : end;
+      segment.read_++;
+      // blank lines are skipped
+      if (line_end != p) {
+        fields.clear();
+        segment.error_ = ParseCsvLine(p, line_end, fields);
+        if (!segment.error_.empty()) {
+          return;
+        }
+        segment.batch_.AddRow(fields);
+      }
+      p = end + 1;
+    }
+  } else {
+    const char *p = segment.begin_;
+    for (uint32_t i = 0; i < segment.row_count_; i++) {
+      segment.read_++;
+      if (segment.end_ - p < static_cast<ptrdiff_t>(sizeof(uint32_t)) ||
+          MACH_READ_UINT32(p) != schema_->GetColumnCount()) {
+        segment.error_ = "malformed row";
+        return;
+      }
+      size_t size = BinaryRowSize(p, segment.end_);
+      if (size == 0) {
+        segment.error_ = "malformed row";
+        return;
+      }
+      Row &row = segment.batch_.AddRow();
+      p += row.DeserializeFrom(const_cast<char *>(p), schema_);
+      for (uint32_t j = 0; j < schema_->GetColumnCount(); j++) {
+        const Column *column = schema_->GetColumn(j);
+        const Field *field = row.GetField(j);
+        if (field->IsNull()) {
+          if (!column->IsNullable()) {
+            segment.error_ = "null in column " + column->GetName();
+            return;
+          }
+          if (!key_index_names_[j].empty()) {
+            segment.error_ = "null key in index " + key_index_names_[j];
+            return;
+          }
+        } else if (column->GetType() == TypeId::kTypeChar && field->GetLength() > column->GetLength()) {
+          // as in a CSV file, a char value must fit its column, index keys are sized by it
+          segment.error_ = "value too long for column " + column->GetName();
+          return;
+        }
+      }
+    }
+    if (p != segment.end_) {
+      segment.error_ = "block size does not match its rows";
+      return;
+    }
+  }
+
+  // the keys are taken here so the inserting thread only moves them
+  segment.keys_.resize(indexes_.size());
+  std::vector<Field> key_fields;
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    segment.keys_[i].reserve(segment.batch_.Size());
+    for (size_t j = 0; j < segment.batch_.Size(); j++) {
+      Row &row = segment.batch_.GetRow(j);
+      key_fields.clear();
+      for (auto column_index : key_maps_[i]) {
+        key_fields.emplace_back(*row.GetField(column_index));
+      }
+      segment.keys_[i].emplace_back(key_fields);
+    }
+  }
+}
+
+size_t CopyLoader::BinaryRowSize(const char *p, const char *end) const {
+  uint32_t column_count = schema_->GetColumnCount();
+  size_t left = end - p;
+  size_t size = sizeof(uint32_t) + (column_count + 7) / 8;
+  if (left < size) {
+    return 0;
+  }
+  const char *null_bitmap = p + sizeof(uint32_t);
+  for (uint32_t i = 0; i < column_count; i++) {
+    if ((null_bitmap[i / 8] & (1 << (i % 8))) != 0) {
+      continue;
+    }
+    TypeId type = schema_->GetColumn(i)->GetType();
+    size_t field_size = Type::GetTypeSize(type);
+    if (type == TypeId::kTypeChar) {
+      // the length comes first and must be there to be read
+      if (left - size < sizeof(uint32_t)) {
+        return 0;
+      }
+      field_size = sizeof(uint32_t) + MACH_READ_UINT32(p + size);
+    }
+    if (left - size < field_size) {
+      return 0;
+    }
+    size += field_size;
+  }
+  return size;
+}
+
+std::string CopyLoader::ParseCsvLine(const char *p, const char *end, std::vector<Field> &fields) const {
+  uint32_t column_count = schema_->GetColumnCount();
+  std::string text;
+  for (uint32_t i = 0; i < column_count; i++) {
+    if (i > 0) {
+      if (p == end || *p != ',') {
+        return "expected " + std::to_string(column_count) + " fields";
+      }
+      p++;
+    }
+    const Column *column = schema_->GetColumn(i);
+    bool quoted = p != end && *p == '"';
+    if (quoted) {
+      text.clear();
+      for (p++;; p++) {
+        if (p == end) {
+          return "unterminated quoted field";
+        }
+        if (*p == '"') {
+          if (p + 1 == end || p[1] != '"') {
+            p++;
+            break;
+          }
+          p++;
+        }
+        text += *p;
+      }
+    } else {
+      auto *field_end = static_cast<const char *>(memchr(p, ',', end - p));
+      field_end = field_end != nullptr ? field_end : end;
+      text.assign(p, field_end);
+      p = field_end;
+    }
+    if (!quoted && text.empty()) {
+      if (!column->IsNullable()) {
+        return "null in column " + column->GetName();
+      }
+      // the index could not place a null key among the others
+      if (!key_index_names_[i].empty()) {
+        return "null key in index " + key_index_names_[i];
+      }
+      fields.emplace_back(column->GetType());
+      continue;
+    }
+    switch (column->GetType()) {
+      case TypeId::kTypeInt: {
+        char *number_end;
+        errno = 0;
+        long value = strtol(text.c_str(), &number_end, 10);
+        if (number_end == text.c_str() || *number_end != '\0' || errno != 0 || value < INT32_MIN ||
+            value > INT32_MAX) {
+          return "invalid int \"" + text + "\" in column " + column->GetName();
+        }
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(value));
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        char *number_end;
+        errno = 0;
+        float value = strtof(text.c_str(), &number_end);
+        if (number_end == text.c_str() || *number_end != '\0' || errno != 0) {
+          return "invalid float \"" + text + "\" in column " + column->GetName();
+        }
+        fields.emplace_back(TypeId::kTypeFloat, value);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        if (text.size() > column->GetLength()) {
+          return "value too long for column " + column->GetName();
+        }
+        fields.emplace_back(TypeId::kTypeChar, text.data(), static_cast<uint32_t>(text.size()), true);
+        break;
+      }
+      default:
+        return "unsupported type of column " + column->GetName();
+    }
+  }
+  if (p != end) {
+    return "expected " + std::to_string(column_count) + " fields";
+  }
+  return "";
+}
+
+bool CopyLoader::InsertSegment(Segment &segment) {
+  Txn *txn = exec_ctx_->GetTransaction();
+  bool inserted = table_info_->GetTableHeap()->BulkInsert(segment.batch_, txn, strategy_.get());
+  // rows that made it in are taken back with the others if the load fails
+  auto &row_ids = segment.batch_.GetRowIds();
+  row_ids_.insert(row_ids_.end(), row_ids.begin(), row_ids.end());
+  if (!inserted) {
+    error_ = "cannot insert rows into table " + table_info_->GetTableName();
+    return false;
+  }
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    keys_[i].insert(keys_[i].end(), std::make_move_iterator(segment.keys_[i].begin()),
+                    std::make_move_iterator(segment.keys_[i].end()));
+  }
+  return true;
+}
+
+bool CopyLoader::BuildIndex(size_t i) {
+  Txn *txn = exec_ctx_->GetTransaction();
+  Index *index = indexes_[i]->GetIndex();
+  if (has_rows_) {
+    std::vector<RowId> result;
+    for (auto &key : keys_[i]) {
+      result.clear();
+      if (index->ScanKey(key, result, txn) == DB_SUCCESS && !result.empty()) {
+        error_ = "duplicate key in index " + indexes_[i]->GetIndexName();
+        return false;
+      }
+    }
+  }
+  if (index->InsertEntries(keys_[i], row_ids_, txn) != DB_SUCCESS) {
+    error_ = "duplicate key in index " + indexes_[i]->GetIndexName();
+    return false;
+  }
+  // the keys are not needed any more
+  std::vector<Row>().swap(keys_[i]);
+  return true;
+}
+
+void CopyLoader::Rollback(size_t built) {
+  Txn *txn = exec_ctx_->GetTransaction();
+  for (size_t i = 0; i < built; i++) {
+    // the keys of a built index are gone, take them from the rows
+    for (auto &row_id : row_ids_) {
+      Row row(row_id);
+      if (!table_info_->GetTableHeap()->GetTuple(&row, txn)) {
+        continue;
+      }
+      std::vector<Field> key_fields;
+      for (auto column_index : key_maps_[i]) {
+        key_fields.emplace_back(*row.GetField(column_index));
+      }
+      indexes_[i]->GetIndex()->RemoveEntry(Row(key_fields), row_id, txn);
+    }
+  }
+  for (auto &row_id : row_ids_) {
+    table_info_->GetTableHeap()->ApplyDelete(row_id, txn);
+  }
+  row_ids_.clear();
+  keys_.assign(indexes_.size(), {});
+}
@@ -15,17 +15,26 @@ void DeleteExecutor::Init() {
   txn_ = exec_ctx_->GetTransaction();
 }
 
-bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  if (child_executor_->Next(row, rid)) {
-    if (!table_info_->GetTableHeap()->MarkDelete(*rid, txn_)) {
-      return false;
-    }
-    Row key_row;
-    for (auto info : index_info_) {  // 更新索引
-      row->GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-      info->GetIndex()->RemoveEntry(key_row, *rid, txn_);
-    }
-    return true;
+bool DeleteExecutor::Next([[maybe_unused]] Row *row, [[maybe_unused]] RowId *rid) {
+  // the deleted row is read into a scratch row, what it took in the arena is taken back before the next one
+  auto arena = exec_ctx_->GetArena();
+  auto mark = arena->GetMark();
+  Row del_row(arena);
+  RowId del_rid;
+  bool deleted = child_executor_->Next(&del_row, &del_rid) && DeleteRow(del_row, del_rid);
+  del_row.destroy();
+  arena->Rewind(mark);
+  return deleted;
+}
+
+bool DeleteExecutor::DeleteRow(Row &del_row, const RowId &del_rid) {
+  if (!table_info_->GetTableHeap()->MarkDelete(del_rid, txn_)) {
+    return false;
+  }
+  Row key_row(exec_ctx_->GetArena());
+  for (auto info : index_info_) {  // 更新索引
+    del_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+    info->GetIndex()->RemoveEntry(key_row, del_rid, txn_);
   }
-  return false;
+  return true;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <chrono>
 
 #include "common/result_writer.h"
+#include "executor/copy_loader.h"
 #include "executor/executors/delete_executor.h"
 #include "executor/executors/index_scan_executor.h"
 #include "executor/executors/insert_executor.h"
@@ -48,9 +49,34 @@ ExecuteEngine::ExecuteEngine() {
         strcmp( stdir->d_name , "..") == 0 ||
         stdir->d_name[0] == '.')
       continue;
-    dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+    dbs_[stdir->d_name] = OpenDatabase(stdir->d_name, false);
   }
   closedir(dir);
+  RebalanceBufferPools();
+}
+
+DBStorageEngine *ExecuteEngine::OpenDatabase(const std::string &db_name, bool init) {
+  return new DBStorageEngine(db_name, init, IDLE_BUFFER_POOL_SIZE, DEFAULT_BUFFER_POOL_INSTANCES, ReplacerType::LRU,
+                             false, BUFFER_POOL_BUDGET);
+}
+
+void ExecuteEngine::RebalanceBufferPools() {
+  if (dbs_.empty()) {
+    return;
+  }
+  // without a database in use the budget is split evenly, else the idle ones keep a little and the rest goes to it
+  size_t even_share = BUFFER_POOL_BUDGET / dbs_.size();
+  size_t idle_size = current_db_.empty() ? even_share : std::min<size_t>(IDLE_BUFFER_POOL_SIZE, even_share);
+  size_t used = 0;
+  for (auto &itr : dbs_) {
+    if (itr.first != current_db_) {
+      // a pinned page may keep a pool larger than asked
+      used += itr.second->bpm_->Resize(idle_size);
+    }
+  }
+  if (!current_db_.empty()) {
+    dbs_[current_db_]->bpm_->Resize(used < BUFFER_POOL_BUDGET ? BUFFER_POOL_BUDGET - used : idle_size);
+  }
 }
 
 std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *exec_ctx,
@@ -97,10 +123,15 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
   try {
     executor->Init();
     RowId rid{};
-    Row row{};
+    Row row(exec_ctx->GetArena());
+    // a row not collected is dropped before the next one, so is what was made in the arena for it
+    auto mark = exec_ctx->GetArena()->GetMark();
     while (executor->Next(&row, &rid)) {
       if (result_set != nullptr) {
-        result_set->push_back(row);
+        result_set->push_back(std::move(row));
+      } else {
+        row.destroy();
+        exec_ctx->GetArena()->Rewind(mark);
       }
     }
   } catch (const exception &ex) {
@@ -149,6 +180,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
       return ExecuteTrxRollback(ast, context.get());
     case kNodeExecFile:
       return ExecuteExecfile(ast, context.get());
+    case kNodeCopy:
+      return ExecuteCopy(ast, context.get());
     case kNodeQuit:
       return ExecuteQuit(ast, context.get());
     default:
@@ -261,7 +294,8 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   if (dbs_.find(db_name) != dbs_.end()) {
     return DB_ALREADY_EXIST;
   }
-  dbs_.insert(make_pair(db_name, new DBStorageEngine(db_name, true)));
+  dbs_.insert(make_pair(db_name, OpenDatabase(db_name, true)));
+  RebalanceBufferPools();
   return DB_SUCCESS;
 }
 
@@ -278,6 +312,7 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   dbs_.erase(db_name);
   if (db_name == current_db_)
     current_db_ = "";
+  RebalanceBufferPools();
   return DB_SUCCESS;
 }
 
@@ -314,6 +349,7 @@ dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *conte
   string db_name = ast->child_->val_;
   if (dbs_.find(db_name) != dbs_.end()) {
     current_db_ = db_name;
+    RebalanceBufferPools();
     cout << "Database changed" << endl;
     return DB_SUCCESS;
   }
@@ -872,7 +908,11 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   // IndexSchema *index_key_actual_schema = catalog_created_index_info->GetIndexKeySchema();
   // ASSERT(index_key_actual_schema != nullptr, "Index key schema is null in created IndexInfo.");
 
-  for (TableIterator it = table_heap->Begin(txn); it != table_heap->End(); ++it) {
+  std::unique_ptr<BufferAccessStrategy> scan_strategy;
+  if (context->GetBufferPoolManager()->IsLargeRelation(table_heap->GetPageCount())) {
+    scan_strategy = std::make_unique<BufferAccessStrategy>(AccessStrategyType::SEQUENTIAL_SCAN);
+  }
+  for (TableIterator it = table_heap->Begin(txn, scan_strategy.get()); it != table_heap->End(); ++it) {
     Row table_row(it->GetRowId());
     if (!table_heap->GetTuple(&table_row, txn)) {
         LOG(WARNING) << "Failed to get tuple for rowid (Page: " << it->GetRowId().GetPageId() 
@@ -1136,3 +1176,52 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   ExecuteInformation(DB_QUIT);
   return DB_QUIT;
 }
+
+dberr_t ExecuteEngine::ExecuteCopy(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteCopy" << std::endl;
+#endif
+  if (context == nullptr || current_db_.empty()) {
+    std::cout << "No database selected." << std::endl;
+    return DB_FAILED;
+  }
+  // AST: kNodeCopy -> kNodeIdentifier (table) -> kNodeString (file) [-> kNodeIdentifier (format)]
+  pSyntaxNode table_node = ast->child_;
+  pSyntaxNode file_node = table_node->next_;
+  pSyntaxNode format_node = file_node->next_;
+  CopyFormat format = CopyFormat::CSV;
+  if (format_node != nullptr) {
+    if (strcmp(format_node->val_, "binary") == 0) {
+      format = CopyFormat::BINARY;
+    } else if (strcmp(format_node->val_, "csv") != 0) {
+      std::cout << "Unknown copy format " << format_node->val_ << ", use csv or binary." << std::endl;
+      return DB_FAILED;
+    }
+  }
+
+  auto start_time = std::chrono::system_clock::now();
+  CatalogManager *catalog_manager = context->GetCatalog();
+  TableInfo *table_info = nullptr;
+  dberr_t result = catalog_manager->GetTable(table_node->val_, table_info);
+  if (result != DB_SUCCESS) {
+    ExecuteInformation(result);
+    return result;
+  }
+  // a table without indexes leaves the list empty
+  std::vector<IndexInfo *> indexes;
+  catalog_manager->GetTableIndexes(table_node->val_, indexes);
+
+  CopyLoader loader(context, table_info, indexes);
+  if (loader.Load(file_node->val_, format) != DB_SUCCESS) {
+    std::cout << "Error: " << loader.GetError() << std::endl;
+    return DB_FAILED;
+  }
+  auto stop_time = std::chrono::system_clock::now();
+  double duration_time =
+      double((std::chrono::duration_cast<std::chrono::milliseconds>(stop_time - start_time)).count());
+  std::stringstream ss;
+  ResultWriter writer(ss);
+  writer.EndInformation(loader.GetRowCount(), duration_time, false);
+  std::cout << writer.stream_.rdbuf();
+  return DB_SUCCESS;
+}
@@ -35,13 +35,12 @@ bool IndexScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *ou
 void IndexScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
                                       Row *output_row) {
   const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
+  output_row->destroy();
+  output_row->SetRowId(RowId());
   for (const auto column : output_columns) {
     auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
+    output_row->AddField(*row->GetField(idx));
   }
-  *output_row = Row(dest_row);
 }
 
 vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
@@ -85,23 +84,26 @@ vector<RowId> IndexScanExecutor::IndexScan(AbstractExpressionRef predicate) {
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
   auto table_schema = table_info_->GetSchema();
+  auto arena = exec_ctx_->GetArena();
   while (cursor_ < result_.size()) {
-    auto p_row = new Row(result_[cursor_]);
-    table_info_->GetTableHeap()->GetTuple(p_row, nullptr);
+    // a row filtered out is taken back from the arena before the next one is read
+    auto mark = arena->GetMark();
+    Row p_row(result_[cursor_], arena);
+    table_info_->GetTableHeap()->GetTuple(&p_row, nullptr);
     if (plan_->need_filter_) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
+      if (!predicate->Evaluate(&p_row).CompareEquals(Field(kTypeInt, 1))) {
+        p_row.destroy();
+        arena->Rewind(mark);
         cursor_++;
-        delete p_row;
         continue;
       }
     }
     *rid = result_[cursor_];
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, plan_->OutputSchema(), p_row, row);
+      TupleTransfer(table_schema, plan_->OutputSchema(), &p_row, row);
     } else {
-      *row = *p_row;
+      *row = std::move(p_row);
     }
-    delete p_row;
     cursor_++;
     return true;
   }
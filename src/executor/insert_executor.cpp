@@ -13,30 +13,41 @@ void InsertExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
   schema_ = table_info_->GetSchema();
   exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->GetTableName(), index_info_);
+  if (exec_ctx_->GetBufferPoolManager()->IsLargeRelation(table_info_->GetTableHeap()->GetPageCount())) {
+    strategy_ = std::make_unique<BufferAccessStrategy>(AccessStrategyType::BULK_WRITE);
+  }
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-    Row insert_row;
-    RowId insert_rid;
-    if (child_executor_->Next(&insert_row, &insert_rid)) {
-        for (auto info: index_info_) {
-            Row key_row;
-            insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-            std::vector<RowId> result;
-            if (!key_row.GetFields().empty() &&
-                info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
-                std::cout << "key already exists" << std::endl;
-                return false;
-            }
-        }
-        if (table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction())) {
-            Row key_row;
-            for (auto info: index_info_) {  // 更新索引
-                insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
-                info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
-            }
-            return true;
-        }
+  // the inserted row is read into a scratch row, what it took in the arena is taken back before the next one
+  auto arena = exec_ctx_->GetArena();
+  auto mark = arena->GetMark();
+  Row insert_row(arena);
+  RowId insert_rid;
+  bool inserted = child_executor_->Next(&insert_row, &insert_rid) && InsertRow(insert_row);
+  insert_row.destroy();
+  arena->Rewind(mark);
+  return inserted;
+}
+
+bool InsertExecutor::InsertRow(Row &insert_row) {
+  for (auto info : index_info_) {
+    Row key_row(exec_ctx_->GetArena());
+    insert_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+    std::vector<RowId> result;
+    if (!key_row.GetFields().empty() &&
+        info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) {
+      std::cout << "key already exists" << std::endl;
+      return false;
+    }
+  }
+  if (!table_info_->GetTableHeap()->InsertTuple(insert_row, exec_ctx_->GetTransaction(), strategy_.get())) {
+    return false;
+  }
+  Row key_row(exec_ctx_->GetArena());
+  for (auto info : index_info_) {  // 更新索引
+    insert_row.GetKeyFromRow(schema_, info->GetIndexKeySchema(), key_row);
+    info->GetIndex()->InsertEntry(key_row, insert_row.GetRowId(), exec_ctx_->GetTransaction());
   }
-  return false;
+  return true;
 }
\ No newline at end of file
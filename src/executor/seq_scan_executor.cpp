@@ -4,10 +4,7 @@
 #include "executor/executors/seq_scan_executor.h"
 
 SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx),
-      plan_(plan),
-      iterator_(nullptr, RowId(INVALID_PAGE_ID, 0), nullptr),
-      is_schema_same_(false) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), is_schema_same_(false) {}
 
 bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *output_schema) {
   auto table_columns = table_schema->GetColumns();
@@ -26,44 +23,36 @@ bool SeqScanExecutor::SchemaEqual(const Schema *table_schema, const Schema *outp
   return true;
 }
 
-void SeqScanExecutor::TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row,
-                                    Row *output_row) {
-  const auto &output_columns = output_schema->GetColumns();
-  std::vector<Field> dest_row;
-  dest_row.reserve(output_columns.size());
-  for (const auto column : output_columns) {
-    auto idx = column->GetTableInd();
-    dest_row.emplace_back(*row->GetField(idx));
-  }
-  *output_row = Row(dest_row);
-}
-
 void SeqScanExecutor::Init() {
   exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info_);
-  auto first_row = table_info_->GetTableHeap()->Begin(nullptr);
-  iterator_ = (table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction()));
+  scanner_.reset();
+  // a large table would push the working set of other queries out of the buffer pool
+  if (exec_ctx_->GetBufferPoolManager()->IsLargeRelation(table_info_->GetTableHeap()->GetPageCount())) {
+    strategy_ = std::make_unique<BufferAccessStrategy>(AccessStrategyType::SEQUENTIAL_SCAN);
+  }
+  scanner_ = std::make_unique<TableScanner>(table_info_->GetTableHeap(), exec_ctx_->GetTransaction(), strategy_.get());
   schema_ = plan_->OutputSchema();
   is_schema_same_ = SchemaEqual(table_info_->GetSchema(), schema_);
+  columns_.clear();
+  for (const auto column : schema_->GetColumns()) {
+    columns_.push_back(column->GetTableInd());
+  }
 }
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
   auto predicate = plan_->GetPredicate();
-  auto table_schema = table_info_->GetSchema();
-  while (iterator_ != table_info_->GetTableHeap()->End()) {
-    auto p_row = &(*iterator_);
-    if (predicate != nullptr) {
-      if (!predicate->Evaluate(p_row).CompareEquals(Field(kTypeInt, 1))) {
-        iterator_++;
-        continue;
-      }
+  while (scanner_->Next()) {
+    const RowView &view = scanner_->GetView();
+    // a row filtered out is only looked at in the page, never copied
+    if (predicate != nullptr && !predicate->Evaluate(view).CompareEquals(Field(kTypeInt, 1))) {
+      continue;
     }
-    *rid = iterator_->GetRowId();
+    *rid = view.GetRowId();
     if (!is_schema_same_) {
-      TupleTransfer(table_schema, schema_, p_row, row);
+      view.ToRow(columns_, *row);
     } else {
-      *row = *p_row;
+      view.ToRow(*row);
     }
-    iterator_++;
     return true;
   }
   return false;
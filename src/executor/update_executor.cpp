@@ -16,52 +16,59 @@ void UpdateExecutor::Init() {
 }
 
 bool UpdateExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
-  Row src_row;
+  // the rows of an update are scratch, what they took in the arena is taken back before the next one
+  auto arena = exec_ctx_->GetArena();
+  auto mark = arena->GetMark();
+  Row src_row(arena);
   RowId src_rid;
-  if (child_executor_->Next(&src_row, &src_rid)) {
-    Row dest_row = GenerateUpdatedTuple(src_row);
-    for (auto info: index_info_) {
-        Row key_row;
-        dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
-        std::vector<RowId> result;
-        if (!key_row.GetFields().empty() &&
-            info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) { //update
-            if(result.size() == 1 && result.at(0) == src_rid){}
-            else {
-              std::cout << "key already exists" << std::endl;
-              return false;
-            }
-        }
-    }
-    
-    if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
-      return false;
-    }
-    Row src_key_row;
-    Row dest_key_row;
-    for (auto info : index_info_) {  // 更新索引
-      src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), src_key_row);
-      dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), dest_key_row);
-      info->GetIndex()->RemoveEntry(src_key_row, src_rid, txn_);
-      info->GetIndex()->InsertEntry(dest_key_row, src_rid, txn_);
-    }
-    return true;
+  bool updated = child_executor_->Next(&src_row, &src_rid) && UpdateRow(src_row, src_rid);
+  src_row.destroy();
+  arena->Rewind(mark);
+  return updated;
+}
+
+bool UpdateExecutor::UpdateRow(Row &src_row, const RowId &src_rid) {
+  Row dest_row = GenerateUpdatedTuple(src_row);
+  for (auto info: index_info_) {
+      Row key_row(exec_ctx_->GetArena());
+      dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), key_row);
+      std::vector<RowId> result;
+      if (!key_row.GetFields().empty() &&
+          info->GetIndex()->ScanKey(key_row, result, exec_ctx_->GetTransaction()) == DB_SUCCESS) { //update
+          if(result.size() == 1 && result.at(0) == src_rid){}
+          else {
+            std::cout << "key already exists" << std::endl;
+            return false;
+          }
+      }
+  }
+
+  if (!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn_)) {
+    return false;
+  }
+  Row src_key_row(exec_ctx_->GetArena());
+  Row dest_key_row(exec_ctx_->GetArena());
+  for (auto info : index_info_) {  // 更新索引
+    src_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), src_key_row);
+    dest_row.GetKeyFromRow(table_info_->GetSchema(), info->GetIndexKeySchema(), dest_key_row);
+    info->GetIndex()->RemoveEntry(src_key_row, src_rid, txn_);
+    info->GetIndex()->InsertEntry(dest_key_row, src_rid, txn_);
   }
-  return false;
+  return true;
 }
 
 Row UpdateExecutor::GenerateUpdatedTuple(const Row &src_row) {
   const auto update_attrs = plan_->GetUpdateAttr();
   Schema *schema = table_info_->GetSchema();
   uint32_t col_count = schema->GetColumnCount();
-  std::vector<Field> values;
+  Row dest_row(exec_ctx_->GetArena());
   for (uint32_t idx = 0; idx < col_count; idx++) {
     if (update_attrs.find(idx) == update_attrs.cend()) {
-      values.emplace_back(*src_row.GetField(idx));
+      dest_row.AddField(*src_row.GetField(idx));
     } else {
       auto expr = update_attrs.at(idx);
-      values.emplace_back(expr->Evaluate(&src_row));
+      dest_row.AddField(expr->Evaluate(&src_row));
     }
   }
-  return Row{values};
+  return dest_row;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include "executor/executors/values_executor.h"
 
+#include "planner/expressions/constant_value_expression.h"
+
 ValuesExecutor::ValuesExecutor(ExecuteContext *exec_ctx, const ValuesPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
@@ -13,12 +15,15 @@ void ValuesExecutor::Init() {
 
 bool ValuesExecutor::Next(Row *row, RowId *rid) {
   if (cursor_ < value_size_) {
-    std::vector<Field> values;
-    auto exprs = plan_->GetValues().at(cursor_);
-    for (auto expr : exprs) {
-      values.emplace_back(expr->Evaluate(nullptr));
+    row->destroy();
+    for (const auto &expr : plan_->GetValues().at(cursor_)) {
+      if (expr->GetType() == ExpressionType::ConstantExpression) {
+        // copied straight into the row, not through a field evaluated on the heap
+        row->AddField(static_cast<ConstantValueExpression *>(expr.get())->val_);
+      } else {
+        row->AddField(expr->Evaluate(nullptr));
+      }
     }
-    *row = Row{values};
     cursor_++;
     return true;
   }
@@ -0,0 +1,65 @@
+#ifndef MINISQL_BUFFER_ACCESS_STRATEGY_H
+#define MINISQL_BUFFER_ACCESS_STRATEGY_H
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+using namespace std;
+
+class BufferPoolManager;
+
+/**
+ * Access pattern hint given to the buffer pool.
+ */
+enum class AccessStrategyType {
+  NORMAL = 0,       // random access, pages compete for the whole pool
+  SEQUENTIAL_SCAN,  // every page is read once, e.g. a full scan of a large table
+  BULK_WRITE        // pages are filled once and not read back soon, e.g. a bulk insert
+};
+
+/**
+ * BufferAccessStrategy is a small private ring of frames owned by one large scan or bulk insert.
+ *
+ * Once the ring is full, the pages read or created through it replace each other instead of pushing the working set
+ * of other queries out of the pool. A ring slot is only reused while its frame still holds the page the ring put
+ * there and nobody pins it, otherwise the slot is refilled through the regular replacer.
+ *
+ * A strategy is not thread-safe and must only be used with a single buffer pool, which must outlive it. Read-ahead
+ * requests that still refer to the strategy are cancelled when it is destroyed.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * @param type the access pattern
+   * @param ring_size number of frames in the ring, 0 for the default size of the access pattern
+   */
+  explicit BufferAccessStrategy(AccessStrategyType type, size_t ring_size = 0) : type_(type), ring_size_(ring_size) {
+    if (ring_size_ == 0) {
+      ring_size_ = type_ == AccessStrategyType::BULK_WRITE ? BULK_WRITE_RING_SIZE : SEQUENTIAL_SCAN_RING_SIZE;
+    }
+  }
+
+  ~BufferAccessStrategy();
+
+  inline AccessStrategyType GetType() const { return type_; }
+
+  inline size_t GetRingSize() const { return ring_size_; }
+
+ private:
+  /** The part of the ring in one buffer pool shard. */
+  struct Ring {
+    vector<pair<frame_id_t, page_id_t>> slots_;  // frame and the page the ring loaded into it
+    size_t next_{0};                              // next slot to reuse once the ring is full
+  };
+
+  AccessStrategyType type_;
+  size_t ring_size_;
+  BufferPoolManager *buffer_pool_manager_{nullptr};  // the pool the strategy is used with, set on first use
+  vector<Ring> rings_;                               // indexed by shard, only accessed under the shard latch
+};
+
+#endif  // MINISQL_BUFFER_ACCESS_STRATEGY_H
@@ -1,10 +1,19 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
@@ -12,27 +21,214 @@
 
 using namespace std;
 
+/**
+ * Counters of FetchPage, summed over all shards.
+ */
+struct BufferPoolStats {
+  uint64_t hits_{0};           // fetches served from the pool
+  uint64_t misses_{0};         // fetches that had to read the page from disk
+  uint64_t prefetches_{0};     // pages read ahead
+  uint64_t prefetch_hits_{0};  // fetches served by a page read ahead, counted in hits_ as well
+  uint64_t background_writes_{0};  // dirty pages cleaned by the background writer
+  uint64_t dirty_pages_{0};        // pages currently dirty in the pool
+};
+
 class BufferPoolManager {
  public:
-  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
+  /** Reads the id of the next page of a chain (table heap, B+ tree leaves) from a page, called with it read latched. */
+  using NextPageFunc = page_id_t (*)(Page *page);
+
+  /**
+   * @param pool_size total number of frames in the buffer pool
+   * @param disk_manager the disk manager backing this buffer pool
+   * @param num_instances number of independent shards the pool is partitioned into, page ids are hashed to a shard
+   * @param replacer_type replacement policy of every shard
+   * @param max_pool_size number of frames Resize can grow the pool to, 0 for pool_size
+   */
+  explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager,
+                             size_t num_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                             ReplacerType replacer_type = ReplacerType::LRU, size_t max_pool_size = 0);
 
   ~BufferPoolManager();
 
   Page *FetchPage(page_id_t page_id);
 
+  /**
+   * Fetch a page, on a miss the frame is taken from the strategy's ring once the ring is full.
+   * @param strategy access pattern of the caller, nullptr behaves like NORMAL
+   * @return nullptr if no frame is free or the page could not be read or fails its checksum
+   */
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy);
+
   bool UnpinPage(page_id_t page_id, bool is_dirty);
 
   bool FlushPage(page_id_t page_id);
 
+  /**
+   * Checkpoint: write every page that is dirty when the call starts back to disk. Pages are written one at a time with
+   * the shard latch released during the write, so foreground fetches go on while the flush runs. The disk manager's
+   * allocation metadata is flushed last, then the disk manager is synced.
+   */
+  void FlushAllPages();
+
   Page *NewPage(page_id_t &page_id);
 
+  /**
+   * Create a new page, its frame is taken from the strategy's ring once the ring is full.
+   * @param strategy access pattern of the caller, nullptr behaves like NORMAL
+   */
+  Page *NewPage(page_id_t &page_id, BufferAccessStrategy *strategy);
+
   bool DeletePage(page_id_t page_id);
 
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
 
+  /**
+   * Grow or shrink the pool online. New frames join the free lists. Shrinking retires frames from the top down: a
+   * dirty page is written back and evicted first, the memory of the retired frames is given back to the OS. Shrinking
+   * stops early at a frame whose page is pinned.
+   *
+   * Only the frames in use have bookkeeping: a Page and an entry in the replacer of their shard are made when a frame
+   * joins the pool and dropped when it is retired. A pool shrunk to a few frames, like an idle database's, costs no
+   * more than that plus address space, whatever its max pool size.
+   * @param pool_size the wanted number of frames, clamped to [number of shards, max pool size]
+   * @return the number of frames of the pool afterwards
+   */
+  size_t Resize(size_t pool_size);
+
+  /** @return the number of frames of the pool */
+  inline size_t GetPoolSize() const { return pool_size_; }
+
+  /** @return the number of frames the pool can grow to */
+  inline size_t GetMaxPoolSize() const { return max_pool_size_; }
+
+  /** @return true if the frames are backed by explicit huge pages */
+  inline bool IsHugeTLB() const { return arena_->IsHugeTLB(); }
+
+  /** @return the number of shards the pool is partitioned into */
+  inline size_t GetNumInstances() const { return num_instances_; }
+
+  /** @return the replacement policy of the pool */
+  inline ReplacerType GetReplacerType() const { return replacer_type_; }
+
+  /** @return true if the pool sits on a read-only disk manager, which rejects page writes */
+  inline bool IsReadOnly() const { return disk_manager_->IsReadOnly(); }
+
+  /**
+   * Read a page and, if next_page is given, the pages following it in its chain into the pool in the background, up
+   * to the prefetch window. Pages already in the pool are skipped. A new request of the same chain and strategy
+   * replaces a queued one, the scan that made it has moved on.
+   * @param next_page reads the next page id of the chain from a page, nullptr to read a single page
+   * @param strategy the ring the pages are read into, nullptr for the shared pool
+   */
+  void Prefetch(page_id_t page_id, NextPageFunc next_page = nullptr, BufferAccessStrategy *strategy = nullptr);
+
+  /** Drop the queued read-ahead requests of a strategy and wait for the running one to finish. */
+  void CancelPrefetch(BufferAccessStrategy *strategy);
+
+  /** @param window number of pages of a chain read ahead by one Prefetch, 0 disables read-ahead */
+  inline void SetPrefetchWindow(size_t window) { prefetch_window_ = window; }
+
+  inline size_t GetPrefetchWindow() const { return prefetch_window_; }
+
+  /** @param ratio the background writer cleans unpinned pages while more than this fraction of the pool is dirty */
+  inline void SetDirtyRatioThreshold(double ratio) { dirty_ratio_threshold_ = ratio; }
+
+  /** @return a snapshot of the fetch counters */
+  BufferPoolStats GetStats();
+
+  /**
+   * @param num_pages size of a relation in pages, 0 if not known
+   * @return true if the relation is large enough to be scanned or bulk loaded through a BufferAccessStrategy ring
+   */
+  inline bool IsLargeRelation(size_t num_pages) const {
+    return num_pages > static_cast<size_t>(large_relation_fraction_ * pool_size_);
+  }
+
+  /** @param fraction relations with more pages than this fraction of the pool are large */
+  inline void SetLargeRelationFraction(double fraction) { large_relation_fraction_ = fraction; }
+
  private:
+  /**
+   * A partition of the buffer pool with its own page table, free list, replacer and latch.
+   * Shard i owns the frames i, i + n, i + 2n, ... (n = num_instances_), the replacer of a shard works on the
+   * shard-local frame index (frame_id / n). The local frames [0, size_) are in use, the ones above are retired by
+   * Resize.
+   *
+   * Disk I/O never runs under the latch: a frame that is being filled is marked io_pending_ and stays pinned, and a
+   * dirty page that has been evicted but not yet written back is listed in evicting_, so that nobody reads a stale
+   * copy of it from disk in the meantime.
+   */
+  struct Shard {
+    unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
+    unordered_map<page_id_t, frame_id_t> evicting_;    // evicted dirty pages -> frame writing them back
+    Replacer *replacer_{nullptr};                      // to find an unpinned page for replacement
+    list<frame_id_t> free_list_;                       // to find a free page for replacement
+    mutex latch_;                                      // to protect shared data structure
+    BufferPoolStats stats_;                            // fetch counters, protected by latch_
+    size_t writer_cursor_{0};                          // local frame the background writer looks at next
+    size_t size_{0};                                   // frames of the shard in use, protected by latch_
+  };
+
+  struct PrefetchRequest {
+    page_id_t page_id_;
+    NextPageFunc next_page_;
+    BufferAccessStrategy *strategy_;
+  };
+
+  static Replacer *CreateReplacer(ReplacerType replacer_type, size_t num_pages);
+
+  /** Grow a shard to size frames, their Pages are constructed. Caller must hold the shard latch. */
+  void GrowShard(Shard &shard, size_t size);
+
+  /**
+   * Retire the frames of a shard from the top down until it has size frames or the top frame is pinned, their Pages are
+   * destroyed.
+   * @param lock the held shard latch, it is released while a dirty page is written back
+   */
+  void ShrinkShard(Shard &shard, unique_lock<mutex> &lock, size_t size);
+
+  /** @return the number of frames shard shard_index has in a pool of pool_size frames */
+  inline size_t ShardSize(size_t shard_index, size_t pool_size) const {
+    return (pool_size - shard_index + num_instances_ - 1) / num_instances_;
+  }
+
+  /** Size the rings of a strategy for the shards of this pool, in the thread that owns the strategy. */
+  void PrepareStrategy(BufferAccessStrategy *strategy);
+
+  /**
+   * Write a dirty page back with the latch released. The frame stays pinned meanwhile, so it is not evicted (the
+   * replacer is not told, a victim that turns out to be pinned is skipped) and it is marked flushing_.
+   * @param lock the held shard latch, it is held again on return
+   */
+  void WriteBack(Shard &shard, unique_lock<mutex> &lock, frame_id_t frame_id);
+
+  /** Pin a dirty page for its write-back and mark it flushing_ and clean. Caller must hold the shard latch. */
+  void BeginWriteBack(Shard &shard, frame_id_t frame_id);
+
+  /** Release a page whose write-back is done. Caller must hold the shard latch. */
+  void EndWriteBack(Shard &shard, frame_id_t frame_id);
+
+  /**
+   * Body of the background writer thread. Each round picks up to BG_WRITER_MAX_PAGES pages and submits their writes
+   * to the disk manager together, then waits for all of them.
+   */
+  void BackgroundWriter();
+
+  /**
+   * Begin the write-back of the next dirty, unpinned page of a shard after its writer cursor.
+   * @return the frame of the page, INVALID_FRAME_ID if the shard has no such page
+   */
+  frame_id_t PickWriteBack(Shard &shard);
+
+  /** Body of the read-ahead thread. */
+  void PrefetchWorker();
+
+  /** Read the pages of a request that are not in the pool yet. */
+  void ReadAhead(const PrefetchRequest &request);
+
   /**
    * Allocate new page (operations like create index/table) For now just keep an increasing counter
    */
@@ -43,16 +239,71 @@ class BufferPoolManager {
    */
   void DeallocatePage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
+  /**
+   * Take a frame for page_id from the strategy's ring if it is full, else from the shard's free list, or evict a
+   * victim. Caller must hold the shard latch.
+   * @param[out] evicted_page_id the evicted page if it is dirty and has to be written back, INVALID_PAGE_ID otherwise
+   * @param strategy the ring to take the frame from and record it in, nullptr for none
+   * @return the frame id, INVALID_FRAME_ID if every frame of the shard is pinned
+   */
+  frame_id_t TryToFindFreePage(Shard &shard, page_id_t page_id, page_id_t &evicted_page_id,
+                               BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Drop the page of a frame that is taken for another page from the page table. Caller must hold the shard latch.
+   * @param[out] evicted_page_id the evicted page if it is dirty and has to be written back, INVALID_PAGE_ID otherwise
+   */
+  void EvictFrame(Shard &shard, frame_id_t frame_id, page_id_t &evicted_page_id);
+
+  /**
+   * Fill a frame reserved by TryToFindFreePage with the latch released: write back the evicted page if any, then read
+   * the frame's page from disk (or zero it for a new page). Wakes up the threads waiting for either page.
+   * @param lock the held shard latch, it is held again on return
+   * @return false if the page could not be read or fails its checksum. The page is dropped from the pool then and the
+   * caller's pin is given up, the frame goes back to the free list once the threads that found it meanwhile let go.
+   */
+  bool LoadFrame(Shard &shard, unique_lock<mutex> &lock, frame_id_t frame_id, page_id_t evicted_page_id,
+                 bool read_from_disk);
+
+  /** Give up a pin on a frame that holds no page, the last one puts it on the free list. */
+  void ReleaseFrame(Shard &shard, frame_id_t frame_id);
+
+  inline Shard &GetShard(page_id_t page_id) { return shards_[static_cast<uint32_t>(page_id) % num_instances_]; }
+
+  inline frame_id_t ToLocalFrameId(frame_id_t frame_id) const {
+    return static_cast<frame_id_t>(frame_id / num_instances_);
+  }
+
+  inline frame_id_t ToFrameId(const Shard &shard, frame_id_t local_frame_id) const {
+    return static_cast<frame_id_t>(local_frame_id * num_instances_ + (&shard - shards_));
+  }
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
-  DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  atomic<size_t> pool_size_;    // number of frames in use, the sum of the shard sizes
+  size_t max_pool_size_;        // number of frames pages_ has room for
+  size_t num_instances_;        // number of shards
+  ReplacerType replacer_type_;  // replacement policy of the shards
+  double large_relation_fraction_{DEFAULT_LARGE_RELATION_FRACTION};
+  Page *pages_;                 // room for the book-keeping of max_pool_size_ frames, constructed for the frames in use
+  unique_ptr<FrameArena> arena_;  // data of the frames, aligned to a huge page
+  DiskManager *disk_manager_;   // pointer to the disk manager.
+  Shard *shards_;               // shards of the buffer pool, indexed by page_id % num_instances_
+  mutex resize_latch_;          // Resize calls run one at a time
+
+  atomic<size_t> prefetch_window_{DEFAULT_PREFETCH_WINDOW};
+  deque<PrefetchRequest> prefetch_queue_;           // pending read-ahead requests
+  BufferAccessStrategy *prefetch_active_{nullptr};  // strategy of the request being read, if any
+  bool prefetch_running_{false};                    // true while the worker reads a request
+  bool prefetch_stop_{false};
+  mutex prefetch_latch_;                  // protects the read-ahead queue and state
+  condition_variable prefetch_cv_;        // signals new requests, finished requests and shutdown
+  thread prefetch_worker_;                // started by the first Prefetch
+
+  atomic<double> dirty_ratio_threshold_{DEFAULT_BG_WRITER_DIRTY_RATIO};
+  bool bg_writer_stop_{false};
+  mutex bg_writer_latch_;
+  condition_variable bg_writer_cv_;  // signals shutdown
+  thread bg_writer_;
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
@@ -1,13 +1,8 @@
 #ifndef MINISQL_CLOCK_REPLACER_H
 #define MINISQL_CLOCK_REPLACER_H
 
-#include <algorithm>
-#include <list>
-#include <map>
-#include <mutex>
-#include <queue>
-#include <unordered_set>
-#include <vector>
+#include <atomic>
+#include <memory>
 
 #include "buffer/replacer.h"
 #include "common/config.h"
@@ -16,6 +11,11 @@ using namespace std;
 
 /**
  * CLOCKReplacer implements the clock replacement.
+ *
+ * Each frame has one atomic state byte holding an evictable flag and a reference bit, and the clock hand is an atomic
+ * counter, so Pin and Unpin are a single atomic read-modify-write and never take a lock. Victim sweeps the hand over
+ * the frames, clearing reference bits until it finds an evictable frame whose bit is already clear.
+ * Frame ids must be less than num_pages.
  */
 class CLOCKReplacer : public Replacer {
  public:
@@ -38,10 +38,16 @@ class CLOCKReplacer : public Replacer {
 
   size_t Size() override;
 
+  void Resize(size_t num_pages) override;
+
  private:
-  size_t capacity;
-  list<frame_id_t> clock_list;               // replacer中可以被替换的数据页
-  map<frame_id_t, frame_id_t> clock_status;  // 数据页的存储状态
+  static constexpr uint8_t EVICTABLE = 0x1;
+  static constexpr uint8_t REFERENCED = 0x2;
+
+  size_t capacity_;
+  unique_ptr<atomic<uint8_t>[]> states_;  // EVICTABLE | REFERENCED bits of each frame
+  atomic<size_t> hand_{0};               // next frame the clock hand looks at, taken modulo capacity_
+  atomic<size_t> size_{0};               // number of evictable frames
 };
 
-#endif  // MINISQL_CLOCK_REPLACER_H
\ No newline at end of file
+#endif  // MINISQL_CLOCK_REPLACER_H
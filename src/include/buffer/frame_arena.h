@@ -0,0 +1,49 @@
+#ifndef MINISQL_FRAME_ARENA_H
+#define MINISQL_FRAME_ARENA_H
+
+#include <cstddef>
+
+#include "common/config.h"
+
+/**
+ * FrameArena is the data area of the buffer pool frames: one mapping of PAGE_SIZE frames, aligned to HUGE_PAGE_SIZE.
+ *
+ * It is backed by explicit huge pages (MAP_HUGETLB) if the system has enough of them reserved, else by normal pages
+ * with transparent huge pages requested through madvise, so a large pool needs few TLB entries. Every frame starts at
+ * a multiple of PAGE_SIZE, as O_DIRECT I/O requires. Frames read as zeros until they are written.
+ */
+class FrameArena {
+ public:
+  /** @param num_frames number of frames the arena has room for */
+  explicit FrameArena(size_t num_frames);
+
+  ~FrameArena();
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  /** @return the data of a frame, PAGE_SIZE bytes */
+  inline char *GetFrame(size_t frame_id) const { return data_ + frame_id * PAGE_SIZE; }
+
+  /** @return number of frames the arena has room for */
+  inline size_t GetNumFrames() const { return num_frames_; }
+
+  /** @return true if the arena is backed by explicit huge pages */
+  inline bool IsHugeTLB() const { return huge_tlb_; }
+
+  /**
+   * Give the memory of the frames [begin, end) back to the OS, they read as zeros afterwards. With explicit huge pages
+   * only the whole huge pages inside the range are given back.
+   */
+  void Release(size_t begin, size_t end);
+
+ private:
+  size_t num_frames_;
+  size_t size_;  // bytes mapped, a multiple of HUGE_PAGE_SIZE
+  char *data_{nullptr};
+  char *mapping_{nullptr};  // start of the mapping, data_ rounded down
+  size_t mapping_size_{0};
+  bool huge_tlb_{false};
+};
+
+#endif  // MINISQL_FRAME_ARENA_H
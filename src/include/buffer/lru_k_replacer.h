@@ -0,0 +1,77 @@
+#ifndef MINISQL_LRU_K_REPLACER_H
+#define MINISQL_LRU_K_REPLACER_H
+
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+using namespace std;
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy (O'Neil et al., SIGMOD 93).
+ *
+ * Every Pin counts as an access to the frame. The victim is the evictable frame whose K-th most recent access is the
+ * oldest, frames with fewer than K accesses (infinite backward K-distance) go first, in LRU order.
+ *
+ * Accesses that follow the previous access of the same frame within the correlated reference period are folded into
+ * it instead of being counted separately. This keeps a page touched by every tuple of a sequential scan at a single
+ * access, so scanned pages are evicted before index pages that are looked up repeatedly. Frames still inside their
+ * correlated period are only victimized when there is no other choice.
+ *
+ * Frame ids must be less than num_pages.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k number of accesses tracked per frame
+   * @param correlated_period accesses of a frame that are at most this many accesses (to any frame) apart are
+   * correlated and count once
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = DEFAULT_LRU_K, size_t correlated_period = DEFAULT_CORRELATED_PERIOD);
+
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  void Resize(size_t num_pages) override;
+
+ private:
+  /** (has K accesses, eviction timestamp, frame id), ordered by eviction priority */
+  using EvictKey = tuple<bool, uint64_t, frame_id_t>;
+
+  /** @return history slot i (0 = most recent uncorrelated access) of a frame */
+  inline uint64_t &History(frame_id_t frame_id, size_t i) { return history_[frame_id * k_ + i]; }
+
+  EvictKey GetEvictKey(frame_id_t frame_id);
+
+  /** Reset the access history of a frame and drop it from the evictable set. */
+  void Forget(frame_id_t frame_id);
+
+ private:
+  size_t capacity_;
+  size_t k_;
+  size_t correlated_period_;
+  uint64_t current_timestamp_{0};
+  vector<uint64_t> history_;       // k_ slots per frame
+  vector<uint64_t> last_access_;   // last access of each frame, correlated ones included
+  vector<uint32_t> access_count_;  // number of valid history slots of each frame, at most k_
+  vector<bool> evictable_;
+  set<EvictKey> evictable_set_;
+  mutex latch_;
+};
+
+#endif  // MINISQL_LRU_K_REPLACER_H
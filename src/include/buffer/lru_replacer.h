@@ -1,12 +1,9 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
 #include <mutex>
-#include <unordered_set>
 #include <vector>
 
-
 #include "buffer/replacer.h"
 #include "common/config.h"
 
@@ -14,6 +11,9 @@ using namespace std;
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * The LRU list is intrusive: the prev/next links live in a node array indexed by frame id that is allocated once in
+ * the constructor, so Pin, Unpin and Victim are O(1) and never allocate. Frame ids must be less than num_pages.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -36,12 +36,27 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
-private:
-  std::list<frame_id_t> lru_list_;
-  std::unordered_set<frame_id_t> lru_set_tracker_;;
-  std::mutex latch_; 
-  size_t capacity_; 
- 
+  void Resize(size_t num_pages) override;
+
+ private:
+  struct Node {
+    frame_id_t prev_;
+    frame_id_t next_;
+    bool in_list_;
+  };
+
+  /** Remove a frame from the list, the frame must be in the list. */
+  void Unlink(frame_id_t frame_id);
+
+  /** Insert a frame at the most recently used end of the list. */
+  void PushFront(frame_id_t frame_id);
+
+ private:
+  /** Links of each frame, nodes_[capacity_] is the list head: its next_ is the MRU frame, its prev_ the LRU frame. */
+  std::vector<Node> nodes_;
+  size_t capacity_;
+  size_t size_{0};
+  std::mutex latch_;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
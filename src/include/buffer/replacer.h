@@ -5,6 +5,11 @@
 
 #include "common/config.h"
 
+/**
+ * Replacement policy used by a buffer pool.
+ */
+enum class ReplacerType { LRU = 0, CLOCK, LRU_K };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,8 +38,21 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame whose page has been deleted, so that it is neither victimized nor keeps any access history.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Change the number of frames tracked, the frames below num_pages keep their state. Dropped ones must not be evictable.
+   * Not safe against concurrent calls of the other methods.
+   * @param num_pages the new number of frames
+   */
+  virtual void Resize(size_t num_pages) = 0;
 };
 
 #endif  // MINISQL_REPLACER_H
@@ -0,0 +1,83 @@
+#ifndef MINISQL_ARENA_H
+#define MINISQL_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * Arena hands out memory by bumping a pointer through blocks and takes it all back at once: on Rewind, Reset or when
+ * it is destroyed. Giving back a single allocation does nothing. An ExecuteContext keeps one for the rows of its query
+ * (see Row(Arena *)), so building and copying rows does not call malloc per field.
+ *
+ * The first block is part of the arena itself, so a small query does not allocate at all. Blocks taken from the heap
+ * after it are kept for reuse until the arena is destroyed. As a std::pmr::memory_resource it can back standard
+ * containers too. Not thread safe.
+ */
+class Arena : public std::pmr::memory_resource {
+ public:
+  static constexpr size_t INLINE_BLOCK_SIZE = 4 * 1024;
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  /** A position in the arena to rewind to. */
+  struct Mark {
+    size_t block_;
+    size_t offset_;
+  };
+
+  Arena() = default;
+
+  ~Arena() override;
+
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  /** Construct an object in the arena, its destructor is never run. */
+  template <typename T, typename... Args>
+  inline T *New(Args &&...args) {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /** @return the current position, what is allocated after it is taken back by Rewind */
+  inline Mark GetMark() const { return {block_, offset_}; }
+
+  /** Take back everything allocated since the mark was got. */
+  inline void Rewind(const Mark &mark) {
+    block_ = mark.block_;
+    offset_ = mark.offset_;
+  }
+
+  /** Take back everything. */
+  inline void Reset() { Rewind({0, 0}); }
+
+  /** @return the bytes of the blocks of the arena, in use or not */
+  size_t GetCapacity() const;
+
+ protected:
+  void *do_allocate(size_t bytes, size_t alignment) override;
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+ private:
+  struct Block {
+    char *data_;
+    size_t size_;
+  };
+
+  /** @return the i-th block, the inline one first */
+  inline Block GetBlock(size_t i) { return i == 0 ? Block{inline_block_, INLINE_BLOCK_SIZE} : blocks_[i - 1]; }
+
+  /** Move on to a block after the current one with room for the allocation, taken from the heap if there is none. */
+  void NextBlock(size_t bytes, size_t alignment);
+
+  alignas(std::max_align_t) char inline_block_[INLINE_BLOCK_SIZE];
+  std::vector<Block> blocks_;  // blocks taken from the heap
+  size_t block_{0};            // block allocations are made from, see GetBlock
+  size_t offset_{0};           // bytes used of the current block
+};
+
+#endif  // MINISQL_ARENA_H
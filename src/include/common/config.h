@@ -14,7 +14,30 @@ static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalo
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
 static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
+static constexpr int PAGE_CHECKSUM_SIZE = 4;            // CRC32C at the end of every page on disk, kept free by pages
+static constexpr int HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // the buffer pool frames are aligned to a huge page
+static constexpr int CACHE_LINE_SIZE = 64;              // frame bookkeeping is aligned to a cache line
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int DEFAULT_BUFFER_POOL_INSTANCES = 1;  // default number of buffer pool shards
+static constexpr int BUFFER_POOL_BUDGET = 2 * DEFAULT_BUFFER_POOL_SIZE;  // frames shared by all open databases
+static constexpr int IDLE_BUFFER_POOL_SIZE = 1024;       // frames left to a database that is not in use
+static constexpr int DEFAULT_LRU_K = 2;                  // default K of the LRU-K replacer
+static constexpr int DEFAULT_CORRELATED_PERIOD = 16;     // default LRU-K correlated reference period, in accesses
+static constexpr int SEQUENTIAL_SCAN_RING_SIZE = 32;     // frames of the ring used by large sequential scans
+static constexpr int BULK_WRITE_RING_SIZE = 64;          // frames of the ring used by bulk inserts
+static constexpr int DEFAULT_PREFETCH_WINDOW = 8;        // pages read ahead of a table or index leaf chain scan
+static constexpr int BG_WRITER_INTERVAL_MS = 50;         // the background writer wakes up this often
+static constexpr int BG_WRITER_MAX_PAGES = 64;           // pages written by the background writer per round at most
+static constexpr int DISK_IO_QUEUE_DEPTH = 64;           // disk reads and writes in flight per io_uring at most
+static constexpr int DISK_IO_THREADS = 4;                // workers of the thread pool disk I/O backend
+static constexpr int DISK_WRITE_BATCH_PAGES = 64;        // queued page writes that are issued together
+static constexpr int DEFAULT_DISK_PREALLOCATE_PAGES = 1024;  // disk space reserved when the file first grows, in pages
+// the background writer cleans unpinned pages while more than this fraction of the pool is dirty
+static constexpr double DEFAULT_BG_WRITER_DIRTY_RATIO = 0.1;
+// tables larger than this fraction of the buffer pool are scanned and bulk loaded through a ring
+static constexpr double DEFAULT_LARGE_RELATION_FRACTION = 0.25;
+// a bulk loaded index fills its pages to this fraction, the rest is left for later inserts
+static constexpr double DEFAULT_BULK_LOAD_FILL_FACTOR = 0.9;
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
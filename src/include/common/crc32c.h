@@ -0,0 +1,20 @@
+#ifndef MINISQL_CRC32C_H
+#define MINISQL_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * CRC32C (Castagnoli) of a buffer. Uses the SSE4.2 crc32 instruction when the CPU has it and a lookup table
+ * otherwise, both give the same result.
+ * @param crc the checksum of the preceding data to continue from, 0 to start
+ */
+uint32_t Crc32c(const char *data, size_t len, uint32_t crc = 0);
+
+/** @return the checksum computed with the lookup table, whatever the CPU supports */
+uint32_t Crc32cSoftware(const char *data, size_t len, uint32_t crc = 0);
+
+/** @return true if Crc32c uses the SSE4.2 instruction */
+bool Crc32cIsHardware();
+
+#endif  // MINISQL_CRC32C_H
@@ -14,7 +14,16 @@
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * @param buffer_pool_instances number of shards of the buffer pool, 1 for a single latch over the whole pool
+   * @param replacer_type replacement policy of the buffer pool
+   * @param read_only open an existing database with its file mapped read-only, init must be false
+   * @param max_buffer_pool_size number of frames the buffer pool can be resized to, 0 for buffer_pool_size
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           uint32_t buffer_pool_instances = DEFAULT_BUFFER_POOL_INSTANCES,
+                           ReplacerType replacer_type = ReplacerType::LRU, bool read_only = false,
+                           uint32_t max_buffer_pool_size = 0);
 
   ~DBStorageEngine();
 
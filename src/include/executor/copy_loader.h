@@ -0,0 +1,124 @@
+#ifndef MINISQL_COPY_LOADER_H
+#define MINISQL_COPY_LOADER_H
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "catalog/indexes.h"
+#include "catalog/table.h"
+#include "common/dberr.h"
+#include "executor/execute_context.h"
+#include "record/row_batch.h"
+
+enum class CopyFormat { CSV, BINARY };
+
+/**
+ * Loads a file into a table for COPY table FROM "file" [csv | binary].
+ *
+ * The file is mapped and cut into segments that worker threads parse into RowBatches, while the calling thread inserts
+ * the finished batches in file order through TableHeap::BulkInsert. The indexes of the table are left alone during the
+ * load: the keys of all loaded rows are collected and each index is built once at the end with Index::InsertEntries.
+ * A load that fails removes the rows it inserted.
+ *
+ * CSV: one row per line ("\n" or "\r\n"), fields separated by ',' in column order. A field may be quoted with '"',
+ * a quote inside a quoted field is written twice. An empty unquoted field is null. Quoted fields must not span lines.
+ *
+ * Binary (size in byte):
+ *  ---------------------------------------------------------------------------------
+ * | Magic "MSQLCOPY" (8) | ColumnCount (4) | Block_1 | ... | Block_N |
+ *  ---------------------------------------------------------------------------------
+ *  Block format, rows in the format of Row::SerializeTo:
+ *  -----------------------------------------------------
+ * | RowCount (4) | Size (4) | Row_1 | ... | Row_M |
+ *  -----------------------------------------------------
+ */
+class CopyLoader {
+ public:
+  static constexpr char BINARY_MAGIC[8] = {'M', 'S', 'Q', 'L', 'C', 'O', 'P', 'Y'};
+  // bytes of CSV text parsed by one worker at a time
+  static constexpr size_t CSV_SEGMENT_SIZE = 1 << 20;
+  // segments parsed ahead of the one being inserted, per worker
+  static constexpr size_t SEGMENTS_IN_FLIGHT = 4;
+
+  /**
+   * @param workers threads parsing the file, 0 for one per hardware thread
+   */
+  CopyLoader(ExecuteContext *exec_ctx, TableInfo *table_info, std::vector<IndexInfo *> indexes, uint32_t workers = 0);
+
+  /**
+   * Load the file into the table.
+   * @return DB_SUCCESS, or DB_FAILED with GetError() telling why, the table is left as it was
+   */
+  dberr_t Load(const std::string &file_name, CopyFormat format);
+
+  /** @return the rows loaded by the last Load */
+  inline uint64_t GetRowCount() const { return row_count_; }
+
+  inline const std::string &GetError() const { return error_; }
+
+  /** Write the header of a binary file for rows of the schema. */
+  static void WriteBinaryHeader(std::ostream &out, const Schema *schema);
+
+  /** Write rows as one block of a binary file. */
+  static void WriteBinaryBlock(std::ostream &out, const std::vector<Row> &rows, Schema *schema);
+
+ private:
+  struct Segment;
+
+  /** Cut the mapped file into segments, false with error_ set if it is malformed. */
+  bool SplitCsv(const char *data, size_t size, std::vector<Segment> &segments);
+
+  bool SplitBinary(const char *data, size_t size, std::vector<Segment> &segments);
+
+  /** Parse the segments on the workers and insert them in order, then build the indexes. */
+  dberr_t LoadSegments(std::vector<Segment> &segments);
+
+  /** Parse a segment into its batch and index keys, or set its error at the first malformed row. */
+  void ParseSegment(Segment &segment) const;
+
+  /**
+   * Measure a binary row with the field count of the schema against the bytes left, before anything is read from it.
+   * @return the size of the row, 0 if its null bitmap or a field runs past end
+   */
+  size_t BinaryRowSize(const char *p, const char *end) const;
+
+  /**
+   * Parse one CSV line, without its line break, into fields.
+   * @return empty if the line is fine, else what is wrong with it
+   */
+  std::string ParseCsvLine(const char *p, const char *end, std::vector<Field> &fields) const;
+
+  /** Insert the batch of a parsed segment and keep its index keys, false if not all rows could be inserted. */
+  bool InsertSegment(Segment &segment);
+
+  /** Build the i-th index from the collected keys, false if a key is there twice. */
+  bool BuildIndex(size_t i);
+
+  /** Take the loaded rows out of the table and out of the first built indexes. */
+  void Rollback(size_t built);
+
+ private:
+  ExecuteContext *exec_ctx_;
+  TableInfo *table_info_;
+  Schema *schema_;
+  std::vector<IndexInfo *> indexes_;
+  // table column of every key column of each index
+  std::vector<std::vector<uint32_t>> key_maps_;
+  // for each table column, the name of an index keyed on it, empty if none
+  std::vector<std::string> key_index_names_;
+  uint32_t workers_;
+  CopyFormat format_{CopyFormat::CSV};
+  // whether the table had rows before the load, so its indexes have keys
+  bool has_rows_{false};
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  // keys and row ids of the rows loaded, for the indexes built at the end
+  std::vector<std::vector<Row>> keys_;
+  std::vector<RowId> row_ids_;
+  uint64_t row_count_{0};
+  std::string error_;
+};
+
+#endif  // MINISQL_COPY_LOADER_H
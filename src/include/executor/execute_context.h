@@ -7,6 +7,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "common/arena.h"
 #include "common/macros.h"
 #include "concurrency/txn.h"
 
@@ -34,6 +35,9 @@ class ExecuteContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /** @return the arena the rows of the query are made in, freed with the context when the query ends */
+  Arena *GetArena() { return &arena_; }
+
  private:
   /** The recovery context associated with this executor context */
   Txn *transaction_;
@@ -41,6 +45,8 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** The memory of the rows of the query */
+  Arena arena_;
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
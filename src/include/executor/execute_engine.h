@@ -41,6 +41,15 @@ class ExecuteEngine {
   void ExecuteInformation(dberr_t result);
 
  private:
+  /** Open a database with a buffer pool that can grow to the whole BUFFER_POOL_BUDGET. */
+  static DBStorageEngine *OpenDatabase(const std::string &db_name, bool init);
+
+  /**
+   * Split BUFFER_POOL_BUDGET frames across the buffer pools of the open databases: the one in use gets what the
+   * others, shrunk to IDLE_BUFFER_POOL_SIZE frames, leave over. Called whenever a database is opened, dropped or used.
+   */
+  void RebalanceBufferPools();
+
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
 
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
@@ -71,6 +80,8 @@ class ExecuteEngine {
 
   dberr_t ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteCopy(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
  private:
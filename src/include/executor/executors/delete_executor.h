@@ -38,12 +38,18 @@ class DeleteExecutor : public AbstractExecutor {
    * NOTE: DeleteExecutor::Next() does not use the `row` out-parameter.
    * NOTE: DeleteExecutor::Next() does not use the `rid` out-parameter.
    */
-  bool Next(Row *row, RowId *rid) override;
+  bool Next([[maybe_unused]] Row *row, [[maybe_unused]] RowId *rid) override;
 
   /** @return The output schema for the delete */
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Delete a row pulled from the child from the table and its indexes.
+   * @return `false` if the table could not mark it deleted
+   */
+  bool DeleteRow(Row &del_row, const RowId &del_rid);
+
   /** The delete plan node to be executed */
   const DeletePlanNode *plan_;
   TableInfo *table_info_{};
@@ -42,12 +42,20 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Insert a row pulled from the child into the table and its indexes.
+   * @return `false` if the row would duplicate a key or the table could not take it
+   */
+  bool InsertRow(Row &insert_row);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableInfo *table_info_{};
   const Schema *schema_{};
   std::vector<IndexInfo *> index_info_;
+  /** Ring the inserts go through if the table is large, nullptr otherwise */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
@@ -5,14 +5,17 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <memory>
 #include <vector>
 
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "storage/table_scanner.h"
 
 /**
- * The SeqScanExecutor executor executes a sequential table scan.
+ * The SeqScanExecutor executor executes a sequential table scan. Tuples are read in place through a TableScanner and
+ * the predicate is evaluated on the RowView, only the rows that pass are copied out.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -39,15 +42,18 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool SchemaEqual(const Schema *table_schema, const Schema *output_schema);
 
-  void TupleTransfer(const Schema *table_schema, const Schema *output_schema, const Row *row, Row *output_row);
-
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableInfo *table_info_{};
-  TableIterator iterator_;
+  /** Ring the scan reads through if the table is large, nullptr otherwise */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  /** Declared after strategy_, it unpins its page before the ring goes away */
+  std::unique_ptr<TableScanner> scanner_;
   const Schema *schema_{};
   bool is_schema_same_;
+  /** Table column of each output column */
+  std::vector<uint32_t> columns_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
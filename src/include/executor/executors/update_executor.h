@@ -44,6 +44,12 @@ class UpdateExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Update a row pulled from the child, in the table and its indexes.
+   * @return `false` if the updated row would duplicate a key or the table could not take it
+   */
+  bool UpdateRow(Row &src_row, const RowId &src_rid);
+
   /**
    * Given a row, creates a new, updated row
    * based on the `UpdateInfo` provided in the plan.
@@ -1,6 +1,7 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <fstream>
 #include <queue>
 #include <string>
 #include <vector>
@@ -35,6 +36,10 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(GenericKey *key, const RowId &value, Txn *transaction = nullptr);
 
+  // Build an empty B+ tree from key & value pairs sorted by key, without duplicates, filling pages to fill_factor.
+  bool BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries,
+                double fill_factor = DEFAULT_BULK_LOAD_FILL_FACTOR);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Txn *transaction = nullptr);
 
@@ -100,6 +105,9 @@ class BPlusTree {
 
   void ToString(BPlusTreePage *page, BufferPoolManager *bpm) const;
 
+  // max size of the leaves, a split leaf keeps the max size of the old one
+  static constexpr int LEAF_MAX_SIZE = 50;
+
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_{INVALID_PAGE_ID};
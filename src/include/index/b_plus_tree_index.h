@@ -11,6 +11,13 @@ class BPlusTreeIndex : public Index {
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Txn *txn) override;
 
+  /**
+   * An empty tree is built bottom up from the sorted entries, a tree with keys gets them inserted in key order.
+   * Keys with a null field are refused, they have no place in the order. A tree with keys is checked for every key
+   * before any is inserted, so a failed load leaves it as it was.
+   */
+  dberr_t InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids, Txn *txn) override;
+
   dberr_t RemoveEntry(const Row &key, RowId row_id, Txn *txn) override;
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Txn *txn, string compare_operator = "=") override;
@@ -2,6 +2,7 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <vector>
 
 #include "common/dberr.h"
 #include "concurrency/txn.h"
@@ -15,6 +16,23 @@ class Index {
 
   virtual dberr_t InsertEntry(const Row &key, RowId row_id, Txn *txn) = 0;
 
+  /**
+   * Insert the entries of a bulk load, e.g. the rows of TableHeap::BulkInsert, an index may build itself in bulk.
+   * Nothing is changed if it fails, the entries inserted before the failing one are taken out again.
+   * @return DB_FAILED if a key is already there or given twice
+   */
+  virtual dberr_t InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids, Txn *txn) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (InsertEntry(keys[i], row_ids[i], txn) != DB_SUCCESS) {
+        for (size_t j = 0; j < i; j++) {
+          RemoveEntry(keys[j], row_ids[j], txn);
+        }
+        return DB_FAILED;
+      }
+    }
+    return DB_SUCCESS;
+  }
+
   virtual dberr_t RemoveEntry(const Row &key, RowId row_id, Txn *txn) = 0;
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Txn *txn, string compare_operator = "=") = 0;
@@ -27,6 +27,9 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
+  /** Read the leaves from next_page_id on ahead of the scan. */
+  void ReadAhead(page_id_t next_page_id);
+
   page_id_t current_page_id{INVALID_PAGE_ID};
   LeafPage *page{nullptr};
   int item_index{0};
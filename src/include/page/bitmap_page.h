@@ -2,6 +2,7 @@
 #define MINISQL_BITMAP_PAGE_H
 
 #include <bitset>
+#include <cstring>
 
 #include "common/config.h"
 #include "common/macros.h"
@@ -47,14 +48,34 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
-  /** Note: need to update if modify page structure. */
-  static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
+  /**
+   * Scan the bitmap a 64-bit word at a time.
+   * @return the first free page at or after from, GetMaxSupportedSize() if there is none
+   */
+  uint32_t FindFreePage(uint32_t from) const;
+
+  /** @return the word_index-th 64 bits of the bitmap, page i of the word is bit i */
+  inline uint64_t LoadWord(size_t word_index) const {
+    uint64_t word;
+    std::memcpy(&word, bytes + word_index * sizeof(uint64_t), sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+  }
+
+  /** Note: need to update if modify page structure. The page checksum is left out, rounded up to whole words. */
+  static constexpr size_t MAX_CHARS = (PageSize - 2 * sizeof(uint32_t) - PAGE_CHECKSUM_SIZE) / sizeof(uint64_t) *
+                                      sizeof(uint64_t);
+  static constexpr size_t NUM_WORDS = MAX_CHARS / sizeof(uint64_t);
+  static_assert(MAX_CHARS % sizeof(uint64_t) == 0, "The bitmap must consist of whole 64-bit words.");
 
  private:
   /** The space occupied by all members of the class should be equal to the PageSize */
   [[maybe_unused]] uint32_t page_allocated_;
-  [[maybe_unused]] uint32_t next_free_page_;
+  [[maybe_unused]] uint32_t next_free_page_;  // no page before it is free
   [[maybe_unused]] unsigned char bytes[MAX_CHARS];
+  [[maybe_unused]] unsigned char reserved_[PageSize - 2 * sizeof(uint32_t) - MAX_CHARS];  // holds the page checksum
 };
 
 #endif  // MINISQL_BITMAP_PAGE_H
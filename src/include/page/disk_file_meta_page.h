@@ -5,10 +5,22 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+static constexpr page_id_t MAX_VALID_PAGE_ID =
+    (PAGE_SIZE - 16 - PAGE_CHECKSUM_SIZE) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 class DiskFileMetaPage {
  public:
+  static constexpr uint32_t MAGIC = 0x4c51536d;  // "mSQL"
+  /**
+   * Version of the db file layout, bumped by every change that an older build would misread:
+   * 2: double-write area in front of the first extent, a checksum at the end of every page, free-space map of a table
+   * in its TableMetadata. Files of version 1, without magic and version in the meta page, are not read.
+   */
+  static constexpr uint32_t FORMAT_VERSION = 2;
+
+  /** @return true for the meta page of a file nothing was allocated in yet */
+  bool IsEmpty() { return magic_ == 0 && version_ == 0 && num_allocated_pages_ == 0 && num_extents_ == 0; }
+
   uint32_t GetExtentNums() { return num_extents_; }
 
   uint32_t GetAllocatedPages() { return num_allocated_pages_; }
@@ -21,6 +33,8 @@ class DiskFileMetaPage {
   }
 
  public:
+  uint32_t magic_{0};
+  uint32_t version_{0};
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
   uint32_t extent_used_page_[0];
@@ -0,0 +1,24 @@
+#ifndef MINISQL_DOUBLE_WRITE_HEADER_PAGE_H
+#define MINISQL_DOUBLE_WRITE_HEADER_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * First page of the double-write area: the physical ids of the pages in the slots following it, in slot order.
+ */
+class DoubleWriteHeaderPage {
+ public:
+  static constexpr uint32_t MAX_PAGES = (PAGE_SIZE - 4 - PAGE_CHECKSUM_SIZE) / 4;
+
+  uint32_t GetPageNums() { return num_pages_; }
+
+  page_id_t GetPageId(uint32_t slot) { return page_ids_[slot]; }
+
+ public:
+  uint32_t num_pages_{0};
+  page_id_t page_ids_[0];
+};
+
+#endif  // MINISQL_DOUBLE_WRITE_HEADER_PAGE_H
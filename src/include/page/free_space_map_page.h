@@ -0,0 +1,54 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * One page of the free-space map of a table heap: the ids of heap pages in chain order, each with its free space in
+ * FREE_SPACE_UNIT byte steps, rounded down. The pages of a map are chained through NextPageId.
+ *
+ * Format (size in byte, M = MAX_ENTRIES):
+ *  --------------------------------------------------------------------------------------------
+ * | NextPageId (4) | Count (4) | PageId_1 (4) | ... | PageId_M (4) | Free_1 (1) | ... | Free_M (1) |
+ *  --------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t MAX_ENTRIES = (PAGE_SIZE - 8 - PAGE_CHECKSUM_SIZE) / (sizeof(page_id_t) + 1);
+  static constexpr uint32_t FREE_SPACE_UNIT = PAGE_SIZE / 256;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetCount() const { return count_; }
+
+  bool IsFull() const { return count_ >= MAX_ENTRIES; }
+
+  page_id_t GetPageId(uint32_t i) const { return page_ids_[i]; }
+
+  uint8_t GetFreeSpace(uint32_t i) const { return reinterpret_cast<const uint8_t *>(page_ids_ + MAX_ENTRIES)[i]; }
+
+  void SetFreeSpace(uint32_t i, uint8_t free_space) {
+    reinterpret_cast<uint8_t *>(page_ids_ + MAX_ENTRIES)[i] = free_space;
+  }
+
+  void Append(page_id_t page_id, uint8_t free_space) {
+    page_ids_[count_] = page_id;
+    SetFreeSpace(count_++, free_space);
+  }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t count_;
+  page_id_t page_ids_[0];
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_PAGE_H
@@ -1,8 +1,10 @@
 #ifndef MINISQL_PAGE_H
 #define MINISQL_PAGE_H
 
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 
 #include "common/config.h"
@@ -12,16 +14,19 @@
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The page data lives in the frame arena of the buffer pool, apart from the book-keeping. Pages are aligned to a cache
+ * line, so that the latches of two frames never share one.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
   DISALLOW_COPY(Page)
 
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor of a page outside a buffer pool, it owns its data. Zeros out the page data. */
+  Page() : owned_data_(new char[PAGE_SIZE]), data_(owned_data_.get()) { ResetMemory(); }
 
   /** Default destructor. */
   ~Page() = default;
@@ -65,17 +70,30 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Constructor of a buffer pool frame, data is the frame in the pool's arena. */
+  explicit Page(char *data) : data_(data) {}
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The data of a page outside a buffer pool. */
+  std::unique_ptr<char[]> owned_data_;
+  /** The actual data that is stored within a page, a frame of the buffer pool's arena or owned_data_. */
+  char *data_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** True while the frame is reserved for a disk read or write-back that runs without the buffer pool latch. */
+  bool io_pending_ = false;
+  /** True while the page is written back without the buffer pool latch and stays in the pool. */
+  bool flushing_ = false;
+  /** True if the page has been read ahead and nobody has fetched it since. */
+  bool prefetched_ = false;
+  /** Signalled when the pending I/O of this frame completes. */
+  std::condition_variable io_done_;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
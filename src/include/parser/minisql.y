@@ -7,12 +7,14 @@
   int yyerror(char* error);
 %}
 
+%define api.header.include {"parser/minisql_yacc.h"}
+
 %union {
 	pSyntaxNode syntax_node;
 }
 
 %token <syntax_node> CREATE DROP SELECT INSERT DELETE UPDATE
-%token <syntax_node> TRXBEGIN TRXCOMMIT TRXROLLBACK QUIT EXECFILE SHOW USE USING
+%token <syntax_node> TRXBEGIN TRXCOMMIT TRXROLLBACK QUIT EXECFILE COPY SHOW USE USING
 %token <syntax_node> DATABASE DATABASES TABLE TABLES INDEX INDEXES
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
@@ -27,7 +29,7 @@
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_copy
 
 %%
 
@@ -58,6 +60,7 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_copy { $$ = $1; }
   ;
 
 sql_create_database:
@@ -393,6 +396,20 @@ sql_exec_file:
   }
   ;
 
+sql_copy:
+  COPY IDENTIFIER FROM STRING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCopy, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  | COPY IDENTIFIER FROM STRING {
+    $$ = CreateSyntaxNode(kNodeCopy, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
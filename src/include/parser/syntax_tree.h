@@ -11,6 +11,7 @@ typedef enum {
   kNodeUnknown,
   kNodeQuit,                 /** quit command */
   kNodeExecFile,             /** execfile command */
+  kNodeCopy,                 /** copy command, contains table identifier, file name and optional format identifier */
   kNodeIdentifier,           /** identifier for database_name, table_name, index_name, column_name... */
   kNodeNumber,               /** numeric value type, eg: int, float */
   kNodeString,               /** string value type, eg: char */
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 class AbstractExpression;
@@ -36,6 +37,13 @@ class AbstractExpression {
   /** @return The field obtained by evaluating the row */
   virtual Field Evaluate(const Row *row) const = 0;
 
+  /**
+   * Evaluate a tuple read in place, e.g. the predicate of a sequential scan. A char field of the result may point
+   * into the viewed bytes or into the expression, it must not outlive either.
+   * @return The field obtained by evaluating the row
+   */
+  virtual Field Evaluate(const RowView &view) const = 0;
+
   /**
    * Returns the field obtained by evaluating a JOIN.
    * @param left_row The left row
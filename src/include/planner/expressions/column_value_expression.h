@@ -27,6 +27,8 @@ class ColumnValueExpression : public AbstractExpression {
 
   Field Evaluate(const Row *row) const override { return Field(*row->GetField(col_idx_)); }
 
+  Field Evaluate(const RowView &view) const override { return view.GetField(col_idx_); }
+
   Field EvaluateJoin(const Row *left_row, const Row *right_row) const override {
     return row_idx_ == 0 ? Field(*left_row->GetField(col_idx_)) : Field(*right_row->GetField(col_idx_));
   }
@@ -2,8 +2,10 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
+#include "common/arena.h"
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "record/field.h"
@@ -19,7 +21,8 @@
  * | Field Nums | Null bitmap |
  * -------------------------------------------
  *
- *
+ * A row made with an arena has its fields, their data and its field list in the arena, they are given back with the
+ * arena and not by the row. A copy made by the copy constructor is in the same arena, a row assigned to keeps its own.
  */
 class Row {
  public:
@@ -35,7 +38,10 @@ class Row {
   }
 
   void destroy() {
-    if (!fields_.empty()) {
+    if (arena_ != nullptr) {
+      // the list goes too, nothing of the row is left in the arena for a Rewind to pull away
+      std::pmr::vector<Field *>(arena_).swap(fields_);
+    } else if (!fields_.empty()) {
       for (auto field : fields_) {
         delete field;
       }
@@ -55,14 +61,20 @@ class Row {
    */
   Row(RowId rid) : rid_(rid) {}
 
+  /**
+   * Row allocated in the arena, nullptr for the heap
+   */
+  explicit Row(Arena *arena) : fields_(GetResource(arena)), arena_(arena) {}
+
+  Row(RowId rid, Arena *arena) : rid_(rid), fields_(GetResource(arena)), arena_(arena) {}
+
   /**
    * Row copy function, deep copy
    */
-  Row(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
+  Row(const Row &other) : rid_(other.rid_), fields_(GetResource(other.arena_)), arena_(other.arena_) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+      CopyField(*field, other.arena_);
     }
   }
 
@@ -70,14 +82,45 @@ class Row {
    * Assign operator, deep copy
    */
   Row &operator=(const Row &other) {
-    destroy();
-    rid_ = other.rid_;
-    for (auto &field : other.fields_) {
-      fields_.push_back(new Field(*field));
+    if (this != &other) {
+      destroy();
+      rid_ = other.rid_;
+      fields_.reserve(other.fields_.size());
+      for (auto &field : other.fields_) {
+        CopyField(*field, other.arena_);
+      }
     }
     return *this;
   }
 
+  /**
+   * Row move function, takes over the fields of other
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), arena_(other.arena_) {
+    other.fields_.clear();
+  }
+
+  /**
+   * Move assign operator, takes over the fields of other if both rows are in the same arena, else copies them
+   */
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      if (arena_ != other.arena_) {
+        return *this = static_cast<const Row &>(other);
+      }
+      destroy();
+      rid_ = other.rid_;
+      fields_ = std::move(other.fields_);
+      other.fields_.clear();
+    }
+    return *this;
+  }
+
+  /**
+   * Append a copy of the field that the row owns, the data of a char field is copied too
+   */
+  void AddField(const Field &field);
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
@@ -98,7 +141,7 @@ class Row {
 
   inline void SetRowId(RowId rid) { rid_ = rid; }
 
-  inline std::vector<Field *> &GetFields() { return fields_; }
+  inline std::pmr::vector<Field *> &GetFields() { return fields_; }
 
   inline Field *GetField(uint32_t idx) const {
     ASSERT(idx < fields_.size(), "Failed to access field");
@@ -107,9 +150,24 @@ class Row {
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /** @return the arena of the row, nullptr if it is on the heap */
+  inline Arena *GetArena() const { return arena_; }
+
  private:
+  static std::pmr::memory_resource *GetResource(Arena *arena) {
+    return arena != nullptr ? arena : std::pmr::new_delete_resource();
+  }
+
+  /**
+   * Append a copy of a field of another row. Between rows on the heap it is made as by the copy constructor of Field,
+   * which leaves the data of a char field shared if the field does not own it.
+   * @param from the arena of the other row
+   */
+  void CopyField(const Field &field, const Arena *from);
+
   RowId rid_{};
-  std::vector<Field *> fields_; /** Make sure that all field ptr are destructed*/
+  std::pmr::vector<Field *> fields_{std::pmr::new_delete_resource()}; /** Make sure that all field ptr are destructed*/
+  Arena *arena_{nullptr};
 };
 
 #endif  // MINISQL_ROW_H
@@ -0,0 +1,41 @@
+#ifndef MINISQL_ROW_BATCH_H
+#define MINISQL_ROW_BATCH_H
+
+#include <deque>
+#include <vector>
+
+#include "record/row.h"
+
+/**
+ * Rows loaded together by TableHeap::BulkInsert, which fills in the row id of each. The rows never move once added.
+ */
+class RowBatch {
+ public:
+  /** Add a row of fields, deep copied. */
+  inline Row &AddRow(std::vector<Field> &fields) { return rows_.emplace_back(fields); }
+
+  /** Add an empty row to be filled in, e.g. by Row::DeserializeFrom. */
+  inline Row &AddRow() { return rows_.emplace_back(); }
+
+  inline size_t Size() const { return rows_.size(); }
+
+  inline bool Empty() const { return rows_.empty(); }
+
+  inline Row &GetRow(size_t i) { return rows_[i]; }
+
+  /** @return the row ids of the rows inserted by the last bulk insert, in row order */
+  inline const std::vector<RowId> &GetRowIds() const { return row_ids_; }
+
+  inline std::vector<RowId> &GetRowIds() { return row_ids_; }
+
+  inline void Clear() {
+    rows_.clear();
+    row_ids_.clear();
+  }
+
+ private:
+  std::deque<Row> rows_;
+  std::vector<RowId> row_ids_;
+};
+
+#endif  // MINISQL_ROW_BATCH_H
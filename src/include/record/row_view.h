@@ -0,0 +1,62 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * A row read in place from its serialized bytes (see Row for the format), e.g. a tuple in a pinned table page. Nothing
+ * is decoded up front: the offset of a field is found on first access by walking the fields before it, and fields are
+ * handed out without copying the bytes, so a row that is looked at and dropped allocates nothing.
+ *
+ * The bytes must stay put as long as the view and the fields got from it are used.
+ */
+class RowView {
+ public:
+  RowView() = default;
+
+  /** View another row, the offsets found for the last one are dropped but their buffer is kept. */
+  void Reset(const char *data, const Schema *schema, RowId rid);
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_count_, "Failed to access field");
+    return (null_bitmap_[idx / 8] & (1 << (idx % 8))) != 0;
+  }
+
+  /** @return the field, a char field points into the viewed bytes instead of owning a copy */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Copy fields out into a row that owns them, in its arena if it has one.
+   * @param columns the fields to copy, in the order of the row
+   */
+  void ToRow(const std::vector<uint32_t> &columns, Row &row) const;
+
+  /** Copy all fields out into a row that owns them. */
+  void ToRow(Row &row) const;
+
+ private:
+  /** @return the offset of a non-null field from the start of the bytes */
+  uint32_t GetOffset(uint32_t idx) const;
+
+ private:
+  const char *data_{nullptr};
+  const Schema *schema_{nullptr};
+  RowId rid_{};
+  uint32_t field_count_{0};
+  const char *null_bitmap_{nullptr};
+  // offsets_[i] is where field i starts, known for the first decoded_ fields
+  mutable std::vector<uint32_t> offsets_;
+  mutable uint32_t decoded_{0};
+};
+
+#endif  // MINISQL_ROW_VIEW_H
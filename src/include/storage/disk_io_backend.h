@@ -0,0 +1,48 @@
+#ifndef MINISQL_DISK_IO_BACKEND_H
+#define MINISQL_DISK_IO_BACKEND_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+enum class DiskIOBackendType { IO_URING = 0, THREAD_POOL };
+
+/**
+ * One read or write of a file range handed to a DiskIOBackend. Once the I/O is done the backend runs done_ with the
+ * number of bytes transferred (less than len_ for a read that hits the end of the file) or -errno, then deletes the
+ * request.
+ */
+struct DiskIORequest {
+  bool is_write_{false};
+  int fd_{-1};
+  uint64_t offset_{0};
+  char *buf_{nullptr};
+  size_t len_{0};
+  std::function<void(ssize_t result)> done_;
+  // owned by the backend while the request is in flight
+  size_t transferred_{0};
+  struct iovec iov_ {};
+};
+
+/**
+ * Asynchronous file I/O. Requests are started by Submit and completed on a backend thread, several at a time; done_
+ * must not wait for other requests of the same backend. Destroying a backend waits for the requests in flight.
+ */
+class DiskIOBackend {
+ public:
+  virtual ~DiskIOBackend() = default;
+
+  virtual void Submit(DiskIORequest *request) = 0;
+
+  virtual DiskIOBackendType GetType() const = 0;
+
+  /**
+   * @param type the preferred backend, IO_URING falls back to THREAD_POOL if the kernel does not support io_uring
+   */
+  static std::unique_ptr<DiskIOBackend> Create(DiskIOBackendType type);
+};
+
+#endif  // MINISQL_DISK_IO_BACKEND_H
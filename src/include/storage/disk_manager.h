@@ -2,45 +2,136 @@
 #define DISK_MGR_H
 
 #include <atomic>
-#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "page/double_write_header_page.h"
+#include "storage/disk_io_backend.h"
+
+/**
+ * Page reads and writes issued to the db file.
+ */
+struct DiskIOStats {
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+  uint64_t checksum_failures_{0};  // pages read whose checksum did not match
+  uint64_t double_writes_{0};      // batches written to the double-write area, one sequential write each
+};
+
+/**
+ * When page writes reach the disk.
+ */
+enum class DiskWriteMode {
+  WRITE_THROUGH = 0,  // every write is made durable with fdatasync before it completes
+  BATCHED             // writes are queued and issued DISK_WRITE_BATCH_PAGES at a time, Sync makes them durable
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
  *
- * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
- * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
- *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N, the double-write area holds
+ * D = DISK_WRITE_BATCH_PAGES pages)
+ * | Meta Page | Double-Write Header | Double-Write Slot 1 | ... | Double-Write Slot D |
+ *      | Free Page BitMap 1 | Page 1 | Page 2 | .... | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * Pages are read and written at their offset in one file descriptor, so page I/O needs no latch and runs
+ * concurrently. db_io_latch_ only serializes the page allocation metadata (meta page and bitmaps).
+ *
+ * The meta page and the bitmaps of all extents are kept in memory, so allocating, freeing and checking a page does no
+ * disk I/O. Changed ones are written back by FlushMetadata, which checkpoints and Close call.
+ *
+ * The file grows in chunks: when AllocatePage hands out a page past the reserved disk space, the next chunk is
+ * reserved with fallocate. The chunk starts at preallocate-pages pages and doubles each time, up to an extent. The file
+ * size stays the same so pages not written yet still read as zeros without disk I/O.
+ *
+ * All page I/O goes through an asynchronous DiskIOBackend (io_uring, or a thread pool where io_uring is missing).
+ * SubmitRead and SubmitWrite return at once and call back on completion, ReadPage and WritePage wait for it.
+ *
+ * In BATCHED write mode (the default) a write copies the page into a queue and completes, reads see the queued copy.
+ * A full queue is written out at once, and Sync writes the queue out. Checkpoints and Close call Sync, so durability
+ * costs a few barriers per batch instead of one per page. In WRITE_THROUGH mode every write is a batch of its own.
+ *
+ * A batch is first written to the double-write area with one sequential write and synced, then written in place and
+ * synced. A page torn by a crash during the in-place write has an intact copy in the area, the constructor puts it
+ * back before anything else is read.
+ *
+ * Every page is written with a CRC32C of its contents in its last PAGE_CHECKSUM_SIZE bytes, which page layouts keep
+ * free. The checksum is checked when the page is read back and cleared before the page is handed out. A mismatch is
+ * logged, counted and reported to the read callback, a page of zeros (never written) passes.
+ *
+ * A read-only disk manager maps the file with mmap instead, a page read is a memcpy out of the mapping and no I/O
+ * backend is started. Page writes, allocation and deallocation are rejected.
+ *
+ * With direct I/O on, the db file is opened O_DIRECT and pages bypass the kernel page cache, so the only cache of the
+ * file is the buffer pool. Every buffer handed to the kernel must then be PAGE_SIZE aligned: the queued copies and the
+ * double-write area are, and so are buffer pool frames. A read into any other buffer goes through an aligned bounce
+ * page. A filesystem that rejects O_DIRECT keeps buffered I/O.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /** Called once an asynchronous page read or write is done, ok is false on an I/O error. */
+  using IOCallback = std::function<void(bool ok)>;
 
-  ~DiskManager() {
+  /**
+   * @param io_backend the preferred disk I/O backend, IO_URING falls back to THREAD_POOL if the kernel lacks io_uring
+   * @param read_only map an existing db file read-only, it is never written
+   */
+  explicit DiskManager(const std::string &db_file, DiskIOBackendType io_backend = DiskIOBackendType::IO_URING,
+                       bool read_only = false);
+
+  virtual ~DiskManager() {
     if (!closed) {
       Close();
     }
   }
 
   /**
-   * Read page from specific page_id
+   * Read page from specific page_id, a page beyond the end of the file reads as zeros
    * Note: page_id = 0 is reserved for free page bit map
+   * @return false if the page could not be read or fails its checksum, page_data must not be used then
    */
-  void ReadPage(page_id_t logical_page_id, char *page_data);
+  virtual bool ReadPage(page_id_t logical_page_id, char *page_data);
 
   /**
    * Write data to specific page
    * Note: page_id = 0 is reserved for free page bit map
    */
-  void WritePage(page_id_t logical_page_id, const char *page_data);
+  virtual void WritePage(page_id_t logical_page_id, const char *page_data);
+
+  /**
+   * Start reading a page, callback runs on an I/O thread once page_data holds it. A page beyond the end of the file
+   * reads as zeros and completes on the calling thread right away. page_data must stay valid until then.
+   */
+  void SubmitRead(page_id_t logical_page_id, char *page_data, IOCallback callback);
+
+  /**
+   * Start writing a page, callback runs on an I/O thread once it is written. page_data must stay valid and unchanged
+   * until then.
+   */
+  void SubmitWrite(page_id_t logical_page_id, const char *page_data, IOCallback callback);
+
+  /** @return the number of page reads and writes issued so far */
+  inline DiskIOStats GetIOStats() const { return {num_reads_, num_writes_, checksum_failures_, double_writes_}; }
+
+  /** @return the disk I/O backend in use, the disk manager must not be read-only */
+  inline DiskIOBackendType GetIOBackendType() const { return io_backend_->GetType(); }
+
+  /** @return the number of torn pages the constructor restored from the double-write area */
+  inline uint32_t GetRepairedPages() const { return repaired_pages_; }
+
+  /** @return true if the db file is mapped read-only */
+  inline bool IsReadOnly() const { return read_only_; }
 
   /**
    * Get next free page from disk
@@ -58,6 +149,34 @@ class DiskManager {
    */
   bool IsPageFree(page_id_t logical_page_id);
 
+  /** @param num_pages disk space reserved when the file grows next, in pages, 0 disables it */
+  inline void SetPreallocatePages(uint32_t num_pages) { preallocate_pages_ = num_pages; }
+
+  /**
+   * Durability barrier: write the queued page writes and wait until every completed write is on stable storage.
+   */
+  void Sync();
+
+  /** Change the write mode, the writes queued so far are synced first. */
+  void SetWriteMode(DiskWriteMode write_mode);
+
+  inline DiskWriteMode GetWriteMode() const { return write_mode_; }
+
+  /**
+   * Turn direct I/O on or off, the writes queued so far are synced first. Turning it on drops the file's pages from
+   * the kernel page cache.
+   * @return true if page I/O bypasses the page cache now, false if it is buffered, also when the filesystem does not
+   * support O_DIRECT
+   */
+  bool SetDirectIO(bool enable);
+
+  inline bool IsDirectIO() const { return direct_io_; }
+
+  /**
+   * Write the meta page and the bitmaps changed since the last flush to disk.
+   */
+  void FlushMetadata();
+
   /**
    * Shut down the disk manager and close all the file resources.
    */
@@ -70,8 +189,22 @@ class DiskManager {
   char *GetMetaData() { return meta_data_; }
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  static constexpr page_id_t DOUBLE_WRITE_PAGE_ID = META_PAGE_ID + 1;  // physical page id of the double-write header
+  static constexpr page_id_t FIRST_EXTENT_PAGE_ID = DOUBLE_WRITE_PAGE_ID + 1 + DISK_WRITE_BATCH_PAGES;
+  static_assert(DISK_WRITE_BATCH_PAGES <= DoubleWriteHeaderPage::MAX_PAGES, "A batch must fit the double-write area.");
 
  private:
+  struct AlignedPageDeleter {
+    void operator()(char *pages) const { operator delete[](pages, std::align_val_t(PAGE_SIZE)); }
+  };
+
+  /** Pages aligned to PAGE_SIZE, as direct I/O needs them. */
+  using AlignedPages = std::unique_ptr<char[], AlignedPageDeleter>;
+
+  static inline AlignedPages NewAlignedPages(size_t num_pages) {
+    return AlignedPages(static_cast<char *>(operator new[](num_pages * PAGE_SIZE, std::align_val_t(PAGE_SIZE))));
+  }
+
   /**
    * Helper function to get disk file size
    */
@@ -79,26 +212,106 @@ class DiskManager {
 
   /**
    * Read physical page from disk
+   * @return false if the page could not be read or fails its checksum
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  bool ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
 
   /**
    * Write data to physical page in disk
    */
   void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
 
+  void SubmitPhysicalRead(page_id_t physical_page_id, char *page_data, IOCallback callback);
+
+  void SubmitPhysicalWrite(page_id_t physical_page_id, const char *page_data, IOCallback callback);
+
+  /** Hand a page write to the I/O backend. */
+  void IssueWrite(page_id_t physical_page_id, const char *page_data, IOCallback callback);
+
+  /**
+   * Look a page up among the queued writes.
+   * @return true if page_data has been filled from the queue
+   */
+  bool ReadFromWriteBatch(page_id_t physical_page_id, char *page_data);
+
+  /** Write the queued pages out together, through the double-write area, and wait for them. */
+  void FlushWriteBatch();
+
+  /** Write up to DISK_WRITE_BATCH_PAGES pages of writing_batch_ to the double-write area and sync it. */
+  void WriteDoubleWriteArea(const page_id_t *page_ids, size_t num_pages);
+
+  /** Restore the pages of the double-write area whose copy in place fails its checksum. */
+  void RepairTornPages();
+
+  /** Raise file_size_ to end if it is smaller. */
+  void GrowFileSize(uint64_t end);
+
+  /** @return the physical page id of the bitmap of an extent */
+  static inline page_id_t BitmapPageId(uint32_t extent_id) {
+    return static_cast<page_id_t>(FIRST_EXTENT_PAGE_ID + extent_id * (1 + BITMAP_SIZE));
+  }
+
+  /** Store the checksum of a page in its last PAGE_CHECKSUM_SIZE bytes. */
+  static void SetChecksum(char *page_data);
+
+  /** @return true if the stored checksum of a page matches or the page is all zeros, the checksum is cleared */
+  static bool CheckAndClearChecksum(char *page_data);
+
+  /**
+   * Check the checksum of a page read from disk and clear it, count and log a mismatch.
+   * @return true if the checksum matches or the page is all zeros
+   */
+  bool VerifyChecksum(page_id_t physical_page_id, char *page_data);
+
+  /** Reserve the next chunk of disk space if a page lies past the reserved one. Caller must hold db_io_latch_. */
+  void Preallocate(page_id_t physical_page_id);
+
+  /** Record in free_extents_ whether an extent has free pages. Caller must hold db_io_latch_. */
+  void UpdateFreeExtent(uint32_t extent_id);
+
   /**
    * Map logical page id to physical page id
    */
   page_id_t MapPageId(page_id_t logical_page_id);
 
  private:
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file
+  int db_fd_{-1};
   std::string file_name_;
-  // with multiple buffer pool instances, need to protect file access
+  // size of the db file, only grows
+  std::atomic<uint64_t> file_size_{0};
+  std::unique_ptr<DiskIOBackend> io_backend_;
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_writes_{0};
+  std::atomic<uint64_t> checksum_failures_{0};
+  std::atomic<uint64_t> double_writes_{0};
+  uint32_t repaired_pages_{0};
+  std::atomic<DiskWriteMode> write_mode_{DiskWriteMode::BATCHED};
+  // queued writes of BATCHED mode, physical page id -> copy of the page, protected by write_batch_latch_
+  std::unordered_map<page_id_t, AlignedPages> write_batch_;
+  // the batch being written out, reads find its pages here until it is done
+  std::unordered_map<page_id_t, AlignedPages> writing_batch_;
+  std::mutex write_batch_latch_;
+  std::mutex flush_batch_latch_;  // batches are written one at a time, in queue order
+  // header and slots of the double-write area as they are written, protected by flush_batch_latch_
+  AlignedPages double_write_buffer_;
+  // with multiple buffer pool instances, need to protect the allocation metadata
   std::recursive_mutex db_io_latch_;
+  // bitmap of each extent, indexed by extent id, protected by db_io_latch_
+  std::vector<std::unique_ptr<BitmapPage<PAGE_SIZE>>> bitmaps_;
+  std::vector<bool> bitmap_dirty_;
+  // one bit per extent, set if the extent has free pages, protected by db_io_latch_
+  std::vector<uint64_t> free_extents_;
+  bool meta_dirty_{false};
+  uint32_t preallocate_pages_{DEFAULT_DISK_PREALLOCATE_PAGES};  // the next chunk, protected by db_io_latch_
+  // the file's disk space is reserved up to here, protected by db_io_latch_
+  uint64_t preallocated_size_{0};
   bool closed{false};
+  bool read_only_{false};
+  // the db file is open with O_DIRECT
+  std::atomic<bool> direct_io_{false};
+  // the whole db file mapped in read-only mode, nullptr if the file is empty
+  const char *mapping_{nullptr};
   char meta_data_[PAGE_SIZE];
 };
 
@@ -0,0 +1,84 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * The free space of every page of a table heap, so an insert goes straight to a page with room.
+ *
+ * The map is kept on a chain of FreeSpaceMapPages and read into memory once, where a max-tree over the free space of
+ * the heap pages finds the first one with room in O(log N). Changes are written through to the map pages. The map is
+ * only a hint: a page with less room than recorded is corrected when an insert into it fails.
+ *
+ * A map without pages (first page id INVALID_PAGE_ID) lives in memory only, its owner fills it in.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * Allocate the first page of a new map that records one heap page.
+   * @return the page id of the map, INVALID_PAGE_ID if no page could be allocated
+   */
+  static page_id_t Create(BufferPoolManager *buffer_pool_manager, page_id_t heap_page_id, uint32_t free_space);
+
+  FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id)
+      : buffer_pool_manager_(buffer_pool_manager), first_page_id_(first_page_id) {}
+
+  /**
+   * Read the map pages into memory, a map without pages starts out empty.
+   * @return false if a map page could not be fetched
+   */
+  bool Load();
+
+  inline bool IsLoaded() const { return loaded_; }
+
+  /** Record a heap page appended to the end of the chain. */
+  void Add(page_id_t heap_page_id, uint32_t free_space);
+
+  /** Record the free space of a heap page, nothing happens for a page the map does not know. */
+  void Update(page_id_t heap_page_id, uint32_t free_space);
+
+  /** @return the first heap page in chain order with at least size bytes free, INVALID_PAGE_ID if there is none */
+  page_id_t Find(uint32_t size) const;
+
+  /** @return the last heap page of the chain the map knows of */
+  inline page_id_t GetLastPageId() const { return heap_page_ids_.empty() ? INVALID_PAGE_ID : heap_page_ids_.back(); }
+
+  inline uint32_t GetPageCount() const { return heap_page_ids_.size(); }
+
+  inline page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  /** Delete the map pages. */
+  void Free();
+
+ private:
+  /** Set the free space of the i-th heap page in the tree. */
+  void SetLeaf(size_t i, uint8_t free_space);
+
+  /** Write the free space of the i-th heap page to its map page, appending an entry if it is new. */
+  void WriteEntry(size_t i, uint8_t free_space);
+
+  static inline uint8_t ToUnits(uint32_t free_space) {
+    return static_cast<uint8_t>(std::min<uint32_t>(free_space / FreeSpaceMapPage::FREE_SPACE_UNIT, UINT8_MAX));
+  }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_;
+  bool loaded_{false};
+  // heap pages in chain order
+  std::vector<page_id_t> heap_page_ids_;
+  std::unordered_map<page_id_t, size_t> positions_;
+  // max-tree of free space units, node i has children 2i and 2i+1, the leaves start at capacity_
+  std::vector<uint8_t> tree_;
+  size_t capacity_{0};
+  // ids of the map pages in chain order
+  std::vector<page_id_t> map_page_ids_;
+};
+
+#endif  // MINISQL_FREE_SPACE_MAP_H
@@ -1,17 +1,22 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <mutex>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
 #include "page/header_page.h"
 #include "page/table_page.h"
+#include "record/row_batch.h"
 #include "recovery/log_manager.h"
+#include "storage/free_space_map.h"
 #include "storage/table_iterator.h"
 
 #include "glog/logging.h"
 
 class TableHeap {
   friend class TableIterator;
+  friend class TableScanner;
 
  public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Txn *txn, LogManager *log_manager,
@@ -19,20 +24,42 @@ class TableHeap {
     return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
   }
 
+  /**
+   * Open a table heap, its free-space map is kept from fsm_page_id on. Without one (INVALID_PAGE_ID) the map is built
+   * in memory by walking the page chain once, on the first insert.
+   */
+  static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, page_id_t fsm_page_id,
+                           Schema *schema, LogManager *log_manager, LockManager *lock_manager) {
+    return new TableHeap(buffer_pool_manager, first_page_id, fsm_page_id, schema, log_manager, lock_manager);
+  }
+
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
                            LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new TableHeap(buffer_pool_manager, first_page_id, INVALID_PAGE_ID, schema, log_manager, lock_manager);
   }
 
   ~TableHeap() {}
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table, into the first page the free-space map finds room in or else a page appended to the
+   * end of the chain. If the tuple is too large (>= page_size), return false.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The recovery performing the insert
+   * @param[in] strategy access strategy for the pages visited and created, nullptr for the shared pool
    * @return true iff the insert is successful
    */
-  bool InsertTuple(Row &row, Txn *txn);
+  bool InsertTuple(Row &row, Txn *txn, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Insert a batch of tuples into freshly allocated pages, filled without latching and linked after the last page in
+   * one step. Space left in existing pages is not used.
+   * @param[in/out] batch rows to insert, the row id of each is set and collected in order in batch.GetRowIds()
+   * @param[in] txn The recovery performing the insert
+   * @param[in] strategy access strategy for the pages created, nullptr for the shared pool
+   * @return true iff all rows are inserted. If a tuple is too large nothing is inserted, if the buffer pool runs out of
+   * frames the rows with a row id in batch.GetRowIds() are.
+   */
+  bool BulkInsert(RowBatch &batch, Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -83,6 +110,7 @@ class TableHeap {
       buffer_pool_manager_->UnpinPage(old_page_id, false);
       buffer_pool_manager_->DeletePage(old_page_id);
     }
+    fsm_.Free();
   }
 
   /**
@@ -91,9 +119,10 @@ class TableHeap {
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param strategy access strategy of the scan, nullptr for the shared pool
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Txn *txn);
+  TableIterator Begin(Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
   /**
    * @return the end iterator of this table
@@ -105,6 +134,17 @@ class TableHeap {
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the id of the first page of the free-space map of this table, INVALID_PAGE_ID if it is kept in memory only
+   */
+  inline page_id_t GetFreeSpaceMapPageId() const { return fsm_.GetFirstPageId(); }
+
+  /**
+   * @return the number of pages of this table, 0 if it is not known yet (opened from disk without a free-space map
+   * and neither fully scanned nor appended to since)
+   */
+  inline uint32_t GetPageCount() const { return page_count_; }
+
  private:
   /**
    * create table heap and initialize first page
@@ -113,6 +153,7 @@ class TableHeap {
                      LockManager *lock_manager)
       : buffer_pool_manager_(buffer_pool_manager),
         schema_(schema),
+        fsm_(buffer_pool_manager, INVALID_PAGE_ID),
         log_manager_(log_manager),
         lock_manager_(lock_manager) {
     // page_id_t first_page_id_temp;
@@ -122,29 +163,60 @@ class TableHeap {
     LOG(ERROR)<<"Failed to allocate the first page for TableHeap.";
     }
   this->first_page_id_ = first_page_id_temp;
+  this->page_count_ = 1;
 
   // Initialize the first page as a TablePage.
   first_page_obj->WLatch();
   first_page_obj->Init(this->first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
+  uint32_t free_space = first_page_obj->GetFreeSpaceRemaining();
   first_page_obj->WUnlatch();
 
   // Unpin the page, marking it as dirty.
   buffer_pool_manager_->UnpinPage(this->first_page_id_, true);
 
+  fsm_ = FreeSpaceMap(buffer_pool_manager_, FreeSpaceMap::Create(buffer_pool_manager_, first_page_id_, free_space));
   };
 
-  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+  explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, page_id_t fsm_page_id,
+                     Schema *schema, LogManager *log_manager, LockManager *lock_manager)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
+        fsm_(buffer_pool_manager, fsm_page_id),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager) {
+    // the page count comes with the map, a heap without one counts its pages on the first insert or full scan
+    if (fsm_page_id != INVALID_PAGE_ID) {
+      LoadFreeSpaceMap(nullptr);
+    }
+  }
+
+  /**
+   * Read the free-space map into memory on first use, a map without pages is filled in from the page chain.
+   * Caller must hold fsm_latch_.
+   */
+  bool LoadFreeSpaceMap(BufferAccessStrategy *strategy);
+
+  /**
+   * @return the id of the last page of the chain, pages linked after the last one in the free-space map are added to
+   * it. Caller must hold fsm_latch_.
+   */
+  page_id_t FindLastPage(BufferAccessStrategy *strategy);
+
+  /** Insert a tuple into a new page linked after the last one. Caller must hold fsm_latch_. */
+  bool AppendPage(Row &row, Txn *txn, BufferAccessStrategy *strategy);
+
+  /** Record the free space of a page after a tuple of it was changed or removed. */
+  void UpdateFreeSpace(page_id_t page_id, uint32_t free_space);
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  uint32_t page_count_{0};  // 0 if unknown
+  // free space of the pages, protected by fsm_latch_, which also keeps two inserts from appending a page at once
+  FreeSpaceMap fsm_;
+  std::mutex fsm_latch_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
@@ -5,12 +5,15 @@
 #include "concurrency/txn.h"
 #include "record/row.h"
 
+class BufferAccessStrategy;
 class TableHeap;
 
 class TableIterator {
+  friend class TableHeap;
+
 public:
  // you may define your own constructor based on your member variables
- explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn);
+ explicit TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, BufferAccessStrategy *strategy = nullptr);
 
  TableIterator(const TableIterator &other);
 
@@ -31,10 +34,15 @@ public:
   TableIterator operator++(int);
 
 private:
+  /** Read the table pages from next_page_id on ahead of the scan. */
+  void ReadAhead(page_id_t next_page_id);
+
   // 添加的成员变量
   TableHeap *table_heap_{nullptr};
   RowId rid_{INVALID_PAGE_ID, 0}; // 默认为无效 RowId
   Txn *txn_{nullptr};
+  BufferAccessStrategy *strategy_{nullptr};  // pages of the scan are fetched through it
+  uint32_t pages_visited_{0};                // pages visited since TableHeap::Begin, 0 if not started there
   Row row_; // 存储当前迭代器指向的 Row 对象// add your own private member variables here
 };
 
@@ -0,0 +1,50 @@
+#ifndef MINISQL_TABLE_SCANNER_H
+#define MINISQL_TABLE_SCANNER_H
+
+#include "common/macros.h"
+#include "concurrency/txn.h"
+#include "record/row_view.h"
+
+class BufferAccessStrategy;
+class TableHeap;
+class TablePage;
+
+/**
+ * Sequential scan of a table heap that reads the tuples in place. The page of the current tuple stays pinned between
+ * calls to Next and the tuple is handed out as a RowView on its bytes, so a tuple the caller only looks at is neither
+ * copied nor allocated for. Unlike TableIterator, which fetches the page again and deserializes every tuple into a Row.
+ *
+ * The page is not latched between calls: as with TableHeap::GetTuple, the caller must keep the current tuple from
+ * being changed while it uses the view.
+ */
+class TableScanner {
+ public:
+  /**
+   * @param strategy access strategy of the scan, nullptr for the shared pool
+   */
+  explicit TableScanner(TableHeap *table_heap, Txn *txn, BufferAccessStrategy *strategy = nullptr);
+
+  ~TableScanner();
+
+  DISALLOW_COPY(TableScanner);
+
+  /** Move to the next tuple, false at the end of the table. */
+  bool Next();
+
+  /** @return the current tuple, valid until the next call to Next */
+  inline const RowView &GetView() const { return view_; }
+
+ private:
+  /** Pin a page of the chain and read the pages after it ahead of the scan, INVALID_PAGE_ID ends the scan. */
+  void FetchPage(page_id_t page_id);
+
+  TableHeap *table_heap_;
+  [[maybe_unused]] Txn *txn_;
+  BufferAccessStrategy *strategy_;
+  TablePage *page_{nullptr};   // pinned page of the current tuple, nullptr at the end
+  uint32_t slot_{0};           // slot of the next tuple to look at in page_
+  uint32_t pages_visited_{0};  // pages visited so far, the page count of the heap once the scan ends
+  RowView view_;
+};
+
+#endif  // MINISQL_TABLE_SCANNER_H
@@ -1,5 +1,6 @@
 #include "index/b_plus_tree.h"
 
+#include <algorithm>
 #include <string>
 
 #include "glog/logging.h"
@@ -19,7 +20,7 @@ BPlusTree::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager
       internal_max_size_(internal_max_size) {
         root_page_id_ = INVALID_PAGE_ID;
         Page *page = buffer_pool_manager->FetchPage(INDEX_ROOTS_PAGE_ID);
-        IndexRootsPage *index_roots_page = reinterpret_cast<IndexRootsPage *>(page);
+        IndexRootsPage *index_roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
         if (!index_roots_page->GetRootId(index_id_, &root_page_id_)) {
             root_page_id_ = INVALID_PAGE_ID;
             UpdateRootPageId(1);
@@ -39,7 +40,7 @@ void BPlusTree::Destroy(page_id_t current_page_id) {
   Page *page = buffer_pool_manager_->FetchPage(current_page_id);
   if (page == nullptr) return;
 
-  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page);
+  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
 
   if (node->IsLeafPage()) {
     buffer_pool_manager_->UnpinPage(current_page_id, true);
@@ -83,7 +84,7 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
 
   page_id_t current_page_id = root_page_id_;
   Page *current_page = buffer_pool_manager_->FetchPage(current_page_id);
-  BPlusTreePage *current_node = reinterpret_cast<BPlusTreePage *>(current_page);
+  BPlusTreePage *current_node = reinterpret_cast<BPlusTreePage *>(current_page->GetData());
 
   while (!current_node->IsLeafPage()) {
     BPlusTreeInternalPage *internal_page =
@@ -93,7 +94,7 @@ bool BPlusTree::GetValue(const GenericKey *key, std::vector<RowId> &result, Txn
     buffer_pool_manager_->UnpinPage(current_page_id, false); // 释放当前页
     current_page_id = next_page_id;
     current_page = buffer_pool_manager_->FetchPage(current_page_id);
-    current_node = reinterpret_cast<BPlusTreePage *>(current_page);
+    current_node = reinterpret_cast<BPlusTreePage *>(current_page->GetData());
   }
 
   BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage *>(current_node);
@@ -139,13 +140,94 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
     throw std::runtime_error("out of memory");
   }
   root_page_id_ = new_page_id;
-  auto *node = reinterpret_cast<BPlusTreeLeafPage *>(page);
-  node->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), 50); // testing
+  auto *node = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+  node->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), LEAF_MAX_SIZE);
   node->Insert(key, value, processor_);
   buffer_pool_manager_->UnpinPage(root_page_id_, true);
   UpdateRootPageId();
 }
 
+/*
+ * Build an empty tree bottom up from entries sorted by key without duplicates.
+ * Each level is spread evenly over as few pages as hold it with every page
+ * filled to at most fill_factor of its max size, so inserts into the loaded
+ * range find room before they split a page. Leaves are filled once and linked
+ * in order, internal pages take the first key of each child as its separator.
+ * @param fill_factor: fraction of a page filled, in (0, 1]
+ * @return: false if the tree is not empty
+ */
+bool BPlusTree::BulkLoad(const std::vector<std::pair<GenericKey *, RowId>> &entries, double fill_factor) {
+  if (!IsEmpty()) {
+    return false;
+  }
+  if (entries.empty()) {
+    return true;
+  }
+  // entries of a page at most, an internal page needs two children to route
+  size_t leaf_fill = std::max<size_t>(1, static_cast<size_t>(LEAF_MAX_SIZE * fill_factor));
+  size_t internal_fill = std::max<size_t>(2, static_cast<size_t>(internal_max_size_ * fill_factor));
+  // the first key and page id of each page of the level being built
+  std::vector<std::pair<GenericKey *, page_id_t>> level;
+  size_t num_leaves = (entries.size() + leaf_fill - 1) / leaf_fill;
+  LeafPage *prev_leaf = nullptr;
+  for (size_t i = 0, begin = 0; i < num_leaves; i++) {
+    size_t end = entries.size() * (i + 1) / num_leaves;
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("out of memory");
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, processor_.GetKeySize(), LEAF_MAX_SIZE);
+    for (size_t j = begin; j < end; j++) {
+      leaf->SetKeyAt(j - begin, entries[j].first);
+      leaf->SetValueAt(j - begin, entries[j].second);
+    }
+    leaf->SetSize(end - begin);
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    prev_leaf = leaf;
+    level.emplace_back(entries[begin].first, page_id);
+    begin = end;
+  }
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+
+  while (level.size() > 1) {
+    std::vector<std::pair<GenericKey *, page_id_t>> parents;
+    size_t num_parents = (level.size() + internal_fill - 1) / internal_fill;
+    for (size_t i = 0, begin = 0; i < num_parents; i++) {
+      size_t end = level.size() * (i + 1) / num_parents;
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(page_id);
+      if (page == nullptr) {
+        throw std::runtime_error("out of memory");
+      }
+      auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+      node->Init(page_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
+      for (size_t j = begin; j < end; j++) {
+        node->SetKeyAt(j - begin, level[j].first);
+        node->SetValueAt(j - begin, level[j].second);
+        Page *child_page = buffer_pool_manager_->FetchPage(level[j].second);
+        if (child_page == nullptr) {
+          throw std::runtime_error("failed to fetch page");
+        }
+        reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(level[j].second, true);
+      }
+      node->SetSize(end - begin);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      parents.emplace_back(level[begin].first, page_id);
+      begin = end;
+    }
+    level.swap(parents);
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId();
+  return true;
+}
+
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
@@ -157,7 +239,7 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
 bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Txn *transaction) {
  // 查找正确的叶子节点
   Page *page = FindLeafPage(key, root_page_id_);
-  auto *node = reinterpret_cast<BPlusTreeLeafPage *>(page);
+  auto *node = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
 
   // 检查键是否已存在
   RowId tmp_value;
@@ -219,7 +301,7 @@ BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Txn *transaction) {
   }
 
   // 初始化新节点
-  BPlusTreeInternalPage *new_node = reinterpret_cast<BPlusTreeInternalPage *>(page);
+  BPlusTreeInternalPage *new_node = reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
   new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), node->GetMaxSize());
 
   // 移动一半数据到新节点
@@ -238,7 +320,7 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Txn *transaction) {
   }
 
   // 初始化新节点
-  BPlusTreeLeafPage *new_node = reinterpret_cast<BPlusTreeLeafPage *>(page);
+  BPlusTreeLeafPage *new_node = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
   new_node->Init(new_page_id, node->GetParentPageId(), node->GetKeySize(), node->GetMaxSize());
 
     // 移动一半数据到新节点
@@ -270,7 +352,7 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
       throw std::runtime_error("out of memory");
     }
 
-    auto *new_root = reinterpret_cast<BPlusTreeInternalPage *>(new_root_page);
+    auto *new_root = reinterpret_cast<BPlusTreeInternalPage *>(new_root_page->GetData());
     new_root->Init(new_page_id, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
 
     // 设置两个子节点
@@ -298,7 +380,7 @@ void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlus
 
   // 获取父节点
   Page *parent_page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
-  auto *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page);
+  auto *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
 
   // 在父节点中插入新子节点及其分隔 key
   page_id_t old_value = parent_node->Lookup(key, processor_);
@@ -333,7 +415,7 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
 
   // 查找正确的叶子页
   Page *page = FindLeafPage(key, root_page_id_);
-  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage *>(page);
+  BPlusTreeLeafPage *leaf_page = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
 
   int old_size = leaf_page->GetSize();
   int new_size = leaf_page->RemoveAndDeleteRecord(key, processor_);
@@ -359,7 +441,7 @@ void BPlusTree::Remove(const GenericKey *key, Txn *transaction) {
       // Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
       // InternalPage *child = reinterpret_cast<InternalPage*>(child_page);
       Page *parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-      InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page);
+      InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
       int index = parent->ValueIndex(child_page_id);
       if(index != 0){
         if(index > 0) parent->SetKeyAt(index, update_key);
@@ -397,7 +479,7 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
   }
 
   Page *parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-  BPlusTreeInternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page);
+  BPlusTreeInternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
 
   // 查找当前节点在父节点中的索引
   int index = -1;
@@ -431,7 +513,7 @@ bool BPlusTree::CoalesceOrRedistribute(N *&node, Txn *transaction) {
 
   // 加载兄弟节点
   Page *sibling_page = buffer_pool_manager_->FetchPage(sibling_page_id);
-  N *sibling_node = reinterpret_cast<N *>(sibling_page);
+  N *sibling_node = reinterpret_cast<N *>(sibling_page->GetData());
 
   // 判断是否需要合并或重新分配
   if (node->GetSize() + sibling_node->GetSize() <= node->GetMaxSize()) {
@@ -497,7 +579,7 @@ bool BPlusTree::Coalesce(LeafPage *&neighbor_node, LeafPage *&node, InternalPage
     // Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
     // InternalPage *child = reinterpret_cast<InternalPage*>(child_page);
     Page *parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page);
+    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
     int index = parent->ValueIndex(child_page_id);
     if(index != 0){
       if(index > 0) parent->SetKeyAt(index, update_key);
@@ -542,7 +624,7 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
   for (int i = left_node->GetSize() - right_node->GetSize(); i < left_node->GetSize(); ++i) {
     page_id_t child_page_id = left_node->ValueAt(i);
     Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
-    BPlusTreePage *child_node = reinterpret_cast<BPlusTreePage *>(child_page);
+    BPlusTreePage *child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     child_node->SetParentPageId(left_node->GetPageId());
     buffer_pool_manager_->UnpinPage(child_page_id, true);
   }
@@ -567,7 +649,7 @@ bool BPlusTree::Coalesce(InternalPage *&neighbor_node, InternalPage *&node, Inte
  */
 void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index) {
   Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  InternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page);
+  InternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
 
   if (index == 0) {
     // 当前节点是第一个子节点，从右兄弟借一个条目插入到当前节点末尾
@@ -609,7 +691,7 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
     // Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
     // InternalPage *child = reinterpret_cast<InternalPage*>(child_page);
     Page *parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page);
+    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
     int index = parent->ValueIndex(child_page_id);
     if(index != 0){
       if(index > 0) parent->SetKeyAt(index, update_key);
@@ -628,7 +710,7 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
     // Page *child_page = buffer_pool_manager_->FetchPage(child_page_id);
     // InternalPage *child = reinterpret_cast<InternalPage*>(child_page);
     Page *parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page);
+    InternalPage *parent = reinterpret_cast<InternalPage*>(parent_page->GetData());
     int index = parent->ValueIndex(child_page_id);
     if(index != 0){
       if(index > 0) parent->SetKeyAt(index, update_key);
@@ -643,7 +725,7 @@ void BPlusTree::Redistribute(LeafPage *neighbor_node, LeafPage *node, int index)
 void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, int index) {
   if (index == 0) {
     // 当前节点是第一个子节点，从右兄弟借一个条目插入到当前节点末尾
-    LeafPage *first_place = reinterpret_cast<LeafPage *>(FindLeafPage(0, neighbor_node->GetPageId(), true));
+    LeafPage *first_place = reinterpret_cast<LeafPage *>(FindLeafPage(0, neighbor_node->GetPageId(), true)->GetData());
     GenericKey *first_key = first_place->KeyAt(0);
     // GenericKey *first_key = neighbor_node->KeyAt(0);
     page_id_t first_child = neighbor_node->ValueAt(0);
@@ -657,7 +739,7 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
 
     // 更新父节点 key
     Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-    InternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page);
+    InternalPage *parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
     parent_node->SetKeyAt(1, neighbor_node->KeyAt(1));  // 新的分隔 key
     buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
 
@@ -666,14 +748,14 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
 
     // 更新被移动子节点的父指针
     Page *child_page = buffer_pool_manager_->FetchPage(first_child);
-    BPlusTreePage *child_node = reinterpret_cast<BPlusTreePage *>(child_page);
+    BPlusTreePage *child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     child_node->SetParentPageId(node->GetPageId());
     buffer_pool_manager_->UnpinPage(first_child, true);
   } else {
     // 当前节点不是第一个子节点，从左兄弟借一个条目插入到当前节点开头
     int last_index = neighbor_node->GetSize() - 1;
     GenericKey *father_key = neighbor_node->KeyAt(last_index);
-    LeafPage *first_place = reinterpret_cast<LeafPage *>(FindLeafPage(0, node->GetPageId(), true));
+    LeafPage *first_place = reinterpret_cast<LeafPage *>(FindLeafPage(0, node->GetPageId(), true)->GetData());
     GenericKey *first_key = first_place->KeyAt(0);
     page_id_t last_child = neighbor_node->ValueAt(last_index);
 
@@ -692,13 +774,13 @@ void BPlusTree::Redistribute(InternalPage *neighbor_node, InternalPage *node, in
 
     // 更新父节点 key
     auto parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-    auto parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page);
+    auto parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
     parent_node->SetKeyAt(index, father_key);  // 或根据具体情况调整
     buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
 
     // 更新被移动子节点的父指针
     auto child_page = buffer_pool_manager_->FetchPage(last_child);
-    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page);
+    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     child_node->SetParentPageId(node->GetPageId());
     buffer_pool_manager_->UnpinPage(last_child, true);
   }
@@ -729,7 +811,7 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
     if (internal_root->GetSize() == 1) {
       page_id_t new_root_id = internal_root->ValueAt(0);
       auto new_root_page = buffer_pool_manager_->FetchPage(new_root_id);
-      auto new_root_node = reinterpret_cast<BPlusTreePage *>(new_root_page);
+      auto new_root_node = reinterpret_cast<BPlusTreePage *>(new_root_page->GetData());
 
       // 更新新根节点的父节点为 INVALID_PAGE_ID
       new_root_node->SetParentPageId(INVALID_PAGE_ID);
@@ -778,7 +860,7 @@ IndexIterator BPlusTree::Begin() {
   // 向下查找最左侧的叶子节点
   while (true) {
       Page *page = buffer_pool_manager_->FetchPage(current_page_id);
-      current_page = reinterpret_cast<BPlusTreePage *>(page);
+      current_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
 
       if (current_page->IsLeafPage()) {
           break;
@@ -813,7 +895,7 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
 
     // 查找包含 key 的叶子页
     Page *page = FindLeafPage(key, root_page_id_, false);
-    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
 
     RowId value;
     int index = leaf_page->KeyIndex(key, processor_);
@@ -847,9 +929,9 @@ IndexIterator BPlusTree::End() {
 Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool leftMost) {
   page_id_t current_page_id = page_id;
   Page *page = buffer_pool_manager_->FetchPage(current_page_id);
-  BPlusTreePage *current_page = reinterpret_cast<BPlusTreePage *>(page);
+  BPlusTreePage *current_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
   if(current_page->IsLeafPage()) {
-    return reinterpret_cast<Page *>(current_page);
+    return page;
   }
   BPlusTreeInternalPage *internal_page;
   page_id_t next_page_id;
@@ -908,7 +990,7 @@ void BPlusTree::UpdateRootPageId(int insert_record) {
     throw std::runtime_error("header page not found");
   }
 
-  IndexRootsPage *header = reinterpret_cast<IndexRootsPage *>(header_page);
+  IndexRootsPage *header = reinterpret_cast<IndexRootsPage *>(header_page->GetData());
 
   if (insert_record) {
     header->Insert(index_id_, root_page_id_);
@@ -1,5 +1,7 @@
 #include "index/b_plus_tree_index.h"
 
+#include <algorithm>
+
 #include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
@@ -26,6 +28,73 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Txn *txn) {
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids, Txn *txn) {
+  if (keys.empty()) {
+    return DB_SUCCESS;
+  }
+  // a null compares as neither less nor greater than anything, the keys could not be ordered with it
+  for (auto &key : keys) {
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      if (key.GetField(i)->IsNull()) {
+        return DB_FAILED;
+      }
+    }
+  }
+  // sort the key rows, comparing serialized keys would deserialize both for every comparison
+  auto compare_rows = [](const Row &a, const Row &b) {
+    for (size_t i = 0; i < a.GetFieldCount(); i++) {
+      if (a.GetField(i)->CompareLessThan(*b.GetField(i)) == CmpBool::kTrue) {
+        return -1;
+      }
+      if (a.GetField(i)->CompareGreaterThan(*b.GetField(i)) == CmpBool::kTrue) {
+        return 1;
+      }
+    }
+    return 0;
+  };
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return compare_rows(keys[a], keys[b]) < 0; });
+  for (size_t i = 1; i < order.size(); i++) {
+    if (compare_rows(keys[order[i - 1]], keys[order[i]]) == 0) {
+      return DB_FAILED;
+    }
+  }
+  // all the keys serialized next to each other, in key order
+  size_t key_size = processor_.GetKeySize();
+  std::vector<char> key_data(keys.size() * key_size);
+  std::vector<std::pair<GenericKey *, RowId>> entries;
+  entries.reserve(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    auto *index_key = reinterpret_cast<GenericKey *>(key_data.data() + i * key_size);
+    processor_.SerializeFromKey(index_key, keys[order[i]], key_schema_);
+    entries.emplace_back(index_key, row_ids[order[i]]);
+  }
+  if (container_.IsEmpty()) {
+    container_.BulkLoad(entries);
+    return DB_SUCCESS;
+  }
+  // a key already in the tree fails the load before any entry goes in
+  std::vector<RowId> result;
+  for (auto &entry : entries) {
+    if (container_.GetValue(entry.first, result, txn)) {
+      return DB_FAILED;
+    }
+  }
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (!container_.Insert(entries[i].first, entries[i].second, txn)) {
+      for (size_t j = 0; j < i; j++) {
+        container_.Remove(entries[j].first, txn);
+      }
+      return DB_FAILED;
+    }
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Txn *txn) {
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
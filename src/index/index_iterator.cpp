@@ -7,9 +7,12 @@ IndexIterator::IndexIterator() = default;
 
 IndexIterator::IndexIterator(page_id_t page_id, BufferPoolManager *bpm, int index)
     : current_page_id(page_id), item_index(index), buffer_pool_manager(bpm) {
-      if(page_id != INVALID_PAGE_ID)
-  page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
-  else page = nullptr;
+  if (page_id != INVALID_PAGE_ID) {
+    page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
+    ReadAhead(page->GetNextPageId());
+  } else {
+    page = nullptr;
+  }
 }
 
 IndexIterator::~IndexIterator() {
@@ -17,6 +20,12 @@ IndexIterator::~IndexIterator() {
     buffer_pool_manager->UnpinPage(current_page_id, false);
 }
 
+void IndexIterator::ReadAhead(page_id_t next_page_id) {
+  buffer_pool_manager->Prefetch(next_page_id, [](Page *page) {
+    return reinterpret_cast<LeafPage *>(page->GetData())->GetNextPageId();
+  });
+}
+
 /**
  * TODO: Student Implement - DONE
  */
@@ -41,6 +50,7 @@ IndexIterator &IndexIterator::operator++() {
     if (current_page_id != INVALID_PAGE_ID) {
       page = reinterpret_cast<LeafPage *>(buffer_pool_manager->FetchPage(current_page_id)->GetData());
       item_index = 0;
+      ReadAhead(page->GetNextPageId());
     } else {
       // 到达 end()
       page = nullptr;
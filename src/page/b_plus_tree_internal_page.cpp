@@ -153,7 +153,7 @@ void InternalPage::CopyNFrom(void *src, int size, BufferPoolManager *buffer_pool
       throw std::runtime_error("Failed to fetch child page during CopyNFrom");
     }
 
-    BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page);
+    BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     bpt_child_page->SetParentPageId(GetPageId());
 
     buffer_pool_manager->UnpinPage(child_page_id, true);
@@ -243,7 +243,7 @@ void InternalPage::CopyLastFrom(GenericKey *key, const page_id_t value, BufferPo
 
   Page *child_page = buffer_pool_manager->FetchPage(value);
   if (child_page != nullptr) {
-    BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page);
+    BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
     bpt_child_page->SetParentPageId(GetPageId());
     buffer_pool_manager->UnpinPage(value, true);
   }
@@ -281,7 +281,7 @@ void InternalPage::CopyFirstFrom(const page_id_t value, BufferPoolManager *buffe
 
     Page *child_page = buffer_pool_manager->FetchPage(value);
     if (child_page != nullptr) {
-        BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page);
+        BPlusTreePage *bpt_child_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
         bpt_child_page->SetParentPageId(GetPageId());
         buffer_pool_manager->UnpinPage(value, true); // Unpin and mark as dirty
     }
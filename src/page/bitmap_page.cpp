@@ -7,56 +7,43 @@
  */
 template <size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
-   if (page_allocated_ >= GetMaxSupportedSize() && GetMaxSupportedSize() > 0) { // 只有在有可管理页时才判断是否已满
-       
-        return false;
-    }
-    if (GetMaxSupportedSize() == 0) { // 如果根本没有可管理的页
-        LOG(WARNING) << "BitmapPage::AllocatePage (ImageLogic): GetMaxSupportedSize() is 0. Cannot allocate.";
-        return false;
+  if (page_allocated_ >= GetMaxSupportedSize()) {
+    return false;
+  }
+  uint32_t offset = next_free_page_;
+  // no page below the hint is free, but a full bitmap written by an older version keeps a stale hint
+  if (offset >= GetMaxSupportedSize() || !IsPageFree(offset)) {
+    offset = FindFreePage(0);
+    if (offset >= GetMaxSupportedSize()) {
+      LOG(ERROR) << "BitmapPage::AllocatePage: page_allocated_ is " << page_allocated_
+                 << " but no page is free. Inconsistency detected.";
+      return false;
     }
+  }
+  bytes[offset / 8] |= (1U << (offset % 8));
+  page_allocated_++;
+  page_offset = offset;
+  next_free_page_ = FindFreePage(offset + 1);
+  return true;
+}
 
-    if (IsPageFree(next_free_page_)) {
-
-        uint32_t byte_to_modify = next_free_page_ / 8;
-        uint8_t bit_to_modify = next_free_page_ % 8;
-
-        if (byte_to_modify >= MAX_CHARS) { // 防御性检查
-             LOG(ERROR) << "BitmapPage::AllocatePage (ImageLogic): Calculated byte_index " << byte_to_modify
-                       << " is out of bounds (MAX_CHARS: " << MAX_CHARS
-                       << ") for next_free_page_ " << next_free_page_ << ". Inconsistency detected.";
-            return false;
-        }
-        bytes[byte_to_modify] |= (1U << bit_to_modify);
-
-        page_offset = next_free_page_;
-
-        page_allocated_++;
-
-        uint32_t scanned_free_index = 0; 
-        
-        if (GetMaxSupportedSize() > 0) { // 仅当有可管理的页时才扫描
-            while (!IsPageFree(scanned_free_index) && (scanned_free_index < GetMaxSupportedSize() - 1) ) {
-                scanned_free_index++; 
-            }
- 
-        } else {
-
-        }
-
-        next_free_page_ = scanned_free_index; 
-       // LOG(INFO) << "BitmapPage::AllocatePage (ImageLogic): Updated next_free_page_ hint to " << next_free_page_;
-
-        return true;
-    } else {
-        LOG(WARNING) << "BitmapPage::AllocatePage (ImageLogic): Initial hint next_free_page_ (" << next_free_page_
-                     << ") is not free or invalid. Allocation failed based on this hint.";
-        return false;
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindFreePage(uint32_t from) const {
+  if (from >= GetMaxSupportedSize()) {
+    return GetMaxSupportedSize();
+  }
+  size_t word_index = from / 64;
+  // treat the pages before from as allocated
+  uint64_t word = LoadWord(word_index) | ((uint64_t{1} << (from % 64)) - 1);
+  while (~word == 0) {
+    if (++word_index == NUM_WORDS) {
+      return GetMaxSupportedSize();
     }
+    word = LoadWord(word_index);
+  }
+  return static_cast<uint32_t>(word_index * 64 + __builtin_ctzll(~word));
 }
 
-
-
 /**
  * TODO: Student Implement
  */
@@ -6,7 +6,8 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
-  SetFreeSpacePointer(PAGE_SIZE);
+  // tuples grow down from the page checksum
+  SetFreeSpacePointer(PAGE_SIZE - PAGE_CHECKSUM_SIZE);
   SetTupleCount(0);
 }
 
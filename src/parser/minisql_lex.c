@@ -1171,13 +1171,16 @@ YY_RULE_SETUP
 #line 208 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
+  if (strcmp(yytext, "copy") == 0) {
+    return COPY;
+  }
   yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
   return IDENTIFIER;
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 217 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1186,7 +1189,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 223 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1195,7 +1198,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 229 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EQ;
@@ -1203,7 +1206,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 234 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NE;
@@ -1211,7 +1214,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 239 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return LE;
@@ -1219,7 +1222,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 244 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return GE;
@@ -1227,7 +1230,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 249 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (',');
@@ -1235,7 +1238,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 254 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('*');
@@ -1243,7 +1246,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 259 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (';');
@@ -1251,7 +1254,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 264 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('\'');
@@ -1259,7 +1262,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 269 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('<');
@@ -1267,7 +1270,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 274 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('>');
@@ -1275,7 +1278,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 279 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('(');
@@ -1283,7 +1286,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 284 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (')');
@@ -1292,14 +1295,14 @@ YY_RULE_SETUP
 case 54:
 /* rule 54 can match eol */
 YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 289 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
 }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 293 "minisql.l"
 {
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
@@ -1308,7 +1311,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 299 "minisql.l"
 ECHO;
 	YY_BREAK
 #line 1314 "../../parser/minisql_lex.c"
@@ -2320,7 +2323,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 299 "minisql.l"
 
 
 int yywrap() {
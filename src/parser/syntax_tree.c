@@ -107,6 +107,8 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeQuit";
     case kNodeExecFile:
       return "kNodeExecFile";
+    case kNodeCopy:
+      return "kNodeCopy";
     case kNodeIdentifier:
       return "kNodeIdentifier";
     case kNodeNumber:
@@ -72,6 +72,24 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 
     bool is_null = (null_bitmap[i / 8] & (1 << (i % 8))) != 0;
 
+    if (arena_ != nullptr) {
+      // read in place and copied into the arena, not through a field on the heap
+      if (is_null) {
+        AddField(Field(type));
+      } else if (type == TypeId::kTypeChar) {
+        uint32_t len = MACH_READ_UINT32(p);
+        AddField(Field(type, p + sizeof(uint32_t), len, false));
+        p += sizeof(uint32_t) + len;
+      } else if (type == TypeId::kTypeInt) {
+        AddField(Field(type, MACH_READ_INT32(p)));
+        p += Type::GetTypeSize(type);
+      } else {
+        AddField(Field(type, MACH_READ_FROM(float, p)));
+        p += Type::GetTypeSize(type);
+      }
+      continue;
+    }
+
     uint32_t bytes_read = Field::DeserializeFrom(p, type, &field, is_null);
 
     // 移动指针 p (如果 is_null=true，bytes_read 为 0，p 不动；否则 p 前进)
@@ -108,12 +126,36 @@ uint32_t Row::GetSerializedSize(Schema *schema) const {
 }
 
 void Row::GetKeyFromRow(const Schema *schema, const Schema *key_schema, Row &key_row) {
-  auto columns = key_schema->GetColumns();
-  std::vector<Field> fields;
+  key_row.destroy();
+  key_row.SetRowId(RowId());
   uint32_t idx;
-  for (auto column : columns) {
+  for (auto column : key_schema->GetColumns()) {
     schema->GetColumnIndex(column->GetName(), idx);
-    fields.emplace_back(*this->GetField(idx));
+    key_row.CopyField(*this->GetField(idx), arena_);
+  }
+}
+
+void Row::AddField(const Field &field) {
+  if (field.GetTypeId() != TypeId::kTypeChar || field.IsNull()) {
+    fields_.push_back(arena_ != nullptr ? arena_->New<Field>(field) : new Field(field));
+    return;
+  }
+  auto data = const_cast<char *>(field.GetData());
+  uint32_t len = field.GetLength();
+  if (arena_ == nullptr) {
+    fields_.push_back(new Field(TypeId::kTypeChar, data, len, true));
+    return;
+  }
+  // the data is in the arena too, the field does not own it
+  auto copy = static_cast<char *>(arena_->allocate(len, 1));
+  memcpy(copy, data, len);
+  fields_.push_back(arena_->New<Field>(TypeId::kTypeChar, copy, len, false));
+}
+
+void Row::CopyField(const Field &field, const Arena *from) {
+  if (arena_ != nullptr || from != nullptr) {
+    AddField(field);
+  } else {
+    fields_.push_back(new Field(field));
   }
-  key_row = Row(fields);
 }
@@ -0,0 +1,71 @@
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, const Schema *schema, RowId rid) {
+  data_ = data;
+  schema_ = schema;
+  rid_ = rid;
+  field_count_ = MACH_READ_UINT32(data);
+  ASSERT(field_count_ == 0 || field_count_ == schema->GetColumnCount(), "Field count mismatch with schema.");
+  null_bitmap_ = data + sizeof(uint32_t);
+  if (offsets_.size() < field_count_ + 1) {
+    offsets_.resize(field_count_ + 1);
+  }
+  // the first field starts right after the header
+  offsets_[0] = sizeof(uint32_t) + (field_count_ + 7) / 8;
+  decoded_ = 1;
+}
+
+uint32_t RowView::GetOffset(uint32_t idx) const {
+  while (decoded_ <= idx) {
+    uint32_t prev = decoded_ - 1;
+    uint32_t size = 0;
+    if (!IsNull(prev)) {
+      TypeId type = schema_->GetColumn(prev)->GetType();
+      if (type == TypeId::kTypeChar) {
+        size = sizeof(uint32_t) + MACH_READ_UINT32(data_ + offsets_[prev]);
+      } else {
+        size = Type::GetTypeSize(type);
+      }
+    }
+    offsets_[decoded_] = offsets_[prev] + size;
+    decoded_++;
+  }
+  return offsets_[idx];
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  const char *p = data_ + GetOffset(idx);
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, MACH_READ_INT32(p));
+    case TypeId::kTypeFloat:
+      return Field(type, MACH_READ_FROM(float, p));
+    case TypeId::kTypeChar:
+      return Field(type, const_cast<char *>(p + sizeof(uint32_t)), MACH_READ_UINT32(p), false);
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return Field(type);
+  }
+}
+
+void RowView::ToRow(const std::vector<uint32_t> &columns, Row &row) const {
+  row.destroy();
+  row.SetRowId(rid_);
+  row.GetFields().reserve(columns.size());
+  for (auto idx : columns) {
+    row.AddField(GetField(idx));
+  }
+}
+
+void RowView::ToRow(Row &row) const {
+  row.destroy();
+  row.SetRowId(rid_);
+  row.GetFields().reserve(field_count_);
+  for (uint32_t i = 0; i < field_count_; i++) {
+    row.AddField(GetField(i));
+  }
+}
@@ -0,0 +1,334 @@
+#include "storage/disk_io_backend.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "glog/logging.h"
+
+namespace {
+
+/**
+ * Run the done callback of a finished request and free it.
+ */
+void FinishRequest(DiskIORequest *request, ssize_t result) {
+  if (request->done_) {
+    request->done_(result);
+  }
+  delete request;
+}
+
+/**
+ * Portable backend: a fixed pool of worker threads runs pread/pwrite for the queued requests.
+ */
+class ThreadPoolBackend : public DiskIOBackend {
+ public:
+  explicit ThreadPoolBackend(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back(&ThreadPoolBackend::Work, this);
+    }
+  }
+
+  ~ThreadPoolBackend() override {
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      stop_ = true;
+      cv_.notify_all();
+    }
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Submit(DiskIORequest *request) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    queue_.push_back(request);
+    cv_.notify_one();
+  }
+
+  DiskIOBackendType GetType() const override { return DiskIOBackendType::THREAD_POOL; }
+
+ private:
+  void Work() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      // the queue is drained before the workers stop
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      DiskIORequest *request = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      FinishRequest(request, Execute(request));
+      lock.lock();
+    }
+  }
+
+  static ssize_t Execute(DiskIORequest *request) {
+    while (request->transferred_ < request->len_) {
+      char *buf = request->buf_ + request->transferred_;
+      size_t len = request->len_ - request->transferred_;
+      off_t offset = static_cast<off_t>(request->offset_ + request->transferred_);
+      ssize_t rc = request->is_write_ ? pwrite(request->fd_, buf, len, offset) : pread(request->fd_, buf, len, offset);
+      if (rc < 0 && errno == EINTR) {
+        continue;
+      }
+      if (rc < 0) {
+        return -errno;
+      }
+      // end of file
+      if (rc == 0) {
+        break;
+      }
+      request->transferred_ += rc;
+    }
+    return static_cast<ssize_t>(request->transferred_);
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<DiskIORequest *> queue_;
+  bool stop_{false};
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+/**
+ * io_uring backend, talks to the kernel through the raw system calls so that it needs no liburing. Submit queues a
+ * readv/writev and enters the kernel, a completion thread waits for completions and reaps all that are ready at once.
+ * At most as many requests as the submission queue has entries are in flight, Submit blocks beyond that.
+ */
+class IoUringBackend : public DiskIOBackend {
+ public:
+  ~IoUringBackend() override {
+    if (completer_.joinable()) {
+      std::unique_lock<std::mutex> lock(sq_latch_);
+      sq_cv_.wait(lock, [this] { return in_flight_ == 0; });
+      // a nop without request tells the completion thread to stop
+      io_uring_sqe *sqe = NextSqe();
+      sqe->opcode = IORING_OP_NOP;
+      sqe->user_data = 0;
+      Publish();
+      Enter();
+      lock.unlock();
+      completer_.join();
+    }
+    Unmap();
+  }
+
+  /**
+   * @return the backend, nullptr if the kernel does not support io_uring
+   */
+  static std::unique_ptr<DiskIOBackend> TryCreate(unsigned entries) {
+    std::unique_ptr<IoUringBackend> backend(new IoUringBackend());
+    if (!backend->Setup(entries)) {
+      return nullptr;
+    }
+    backend->completer_ = std::thread(&IoUringBackend::Complete, backend.get());
+    return backend;
+  }
+
+  void Submit(DiskIORequest *request) override {
+    std::unique_lock<std::mutex> lock(sq_latch_);
+    sq_cv_.wait(lock, [this] { return in_flight_ < sq_entries_; });
+    in_flight_++;
+    Push(request);
+  }
+
+  DiskIOBackendType GetType() const override { return DiskIOBackendType::IO_URING; }
+
+ private:
+  IoUringBackend() = default;
+
+  bool Setup(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      LOG(INFO) << "io_uring is not available (" << strerror(errno) << "), using the thread pool disk I/O backend";
+      return false;
+    }
+    sq_entries_ = params.sq_entries;
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                    IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                  IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                      IORING_OFF_SQES);
+    if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+      LOG(WARNING) << "Can not map the io_uring queues: " << strerror(errno);
+      sqes_ = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe *>(sqes);
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  /** Release the rings and the io_uring, also after a failed Setup. */
+  void Unmap() {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+  }
+
+  /** Take the next submission queue entry, it is queued by Publish. Caller must hold sq_latch_. */
+  io_uring_sqe *NextSqe() {
+    unsigned index = *sq_tail_ & *sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    return sqe;
+  }
+
+  /** Queue the entry taken by NextSqe, the kernel reads it once it sees the new tail. Caller must hold sq_latch_. */
+  void Publish() {
+    __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+    unsubmitted_++;
+  }
+
+  /** Queue the rest of a request and hand it to the kernel. Caller must hold sq_latch_. */
+  void Push(DiskIORequest *request) {
+    request->iov_.iov_base = request->buf_ + request->transferred_;
+    request->iov_.iov_len = request->len_ - request->transferred_;
+    io_uring_sqe *sqe = NextSqe();
+    sqe->opcode = request->is_write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = request->fd_;
+    sqe->off = request->offset_ + request->transferred_;
+    sqe->addr = reinterpret_cast<uint64_t>(&request->iov_);
+    sqe->len = 1;
+    sqe->user_data = reinterpret_cast<uint64_t>(request);
+    Publish();
+    Enter();
+  }
+
+  /** Submit the queued entries. Caller must hold sq_latch_. */
+  void Enter() {
+    while (unsubmitted_ > 0) {
+      int rc = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, unsubmitted_, 0, 0, nullptr, 0));
+      if (rc < 0 && (errno == EINTR || errno == EAGAIN)) {
+        continue;
+      }
+      if (rc < 0) {
+        // the entries stay queued and go with the next submission
+        LOG(ERROR) << "io_uring_enter failed: " << strerror(errno);
+        return;
+      }
+      unsubmitted_ -= rc;
+    }
+  }
+
+  /** Body of the completion thread. */
+  void Complete() {
+    std::vector<std::pair<uint64_t, int32_t>> completions;
+    bool stop = false;
+    while (!stop) {
+      int rc = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (rc < 0 && errno != EINTR) {
+        LOG(ERROR) << "io_uring_enter failed while waiting for completions: " << strerror(errno);
+      }
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++) {
+        io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+        completions.emplace_back(cqe->user_data, cqe->res);
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      for (auto &completion : completions) {
+        if (completion.first == 0) {
+          stop = true;
+        } else {
+          OnComplete(reinterpret_cast<DiskIORequest *>(completion.first), completion.second);
+        }
+      }
+      completions.clear();
+    }
+  }
+
+  void OnComplete(DiskIORequest *request, int32_t res) {
+    if (res > 0) {
+      request->transferred_ += res;
+    }
+    // a short transfer or an interrupted one goes on with the rest, a read of 0 bytes is the end of the file
+    if ((res > 0 && request->transferred_ < request->len_) || res == -EINTR || res == -EAGAIN) {
+      std::lock_guard<std::mutex> guard(sq_latch_);
+      Push(request);
+      return;
+    }
+    FinishRequest(request, res < 0 ? res : static_cast<ssize_t>(request->transferred_));
+    std::lock_guard<std::mutex> guard(sq_latch_);
+    in_flight_--;
+    sq_cv_.notify_all();
+  }
+
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  void *cq_ring_{nullptr};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+  unsigned sq_entries_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  unsigned in_flight_{0};    // requests submitted and not finished yet
+  unsigned unsubmitted_{0};  // entries queued but not taken by the kernel yet
+  std::mutex sq_latch_;      // protects the submission queue and the counters
+  std::condition_variable sq_cv_;
+  std::thread completer_;
+};
+
+}  // namespace
+
+std::unique_ptr<DiskIOBackend> DiskIOBackend::Create(DiskIOBackendType type) {
+  if (type == DiskIOBackendType::IO_URING) {
+    std::unique_ptr<DiskIOBackend> backend = IoUringBackend::TryCreate(DISK_IO_QUEUE_DEPTH);
+    if (backend != nullptr) {
+      return backend;
+    }
+  }
+  return std::unique_ptr<DiskIOBackend>(new ThreadPoolBackend(DISK_IO_THREADS));
+}
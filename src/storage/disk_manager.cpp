@@ -1,243 +1,265 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
 #include <filesystem>
+#include <future>
 #include <stdexcept>
+#include <vector>
 
+#include "common/crc32c.h"
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackendType io_backend, bool read_only)
+    : file_name_(db_file), read_only_(read_only) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    std::filesystem::path p = db_file;
-    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
+  // directory does not exist
+  std::filesystem::path p = db_file;
+  if (!read_only_ && p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+  db_fd_ = read_only_ ? open(db_file.c_str(), O_RDONLY) : open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (db_fd_ < 0) {
+    LOG(ERROR) << "Can not open db file " << db_file << ": " << strerror(errno);
+    throw std::exception();
+  }
+  int file_size = GetFileSize(file_name_);
+  file_size_ = file_size < 0 ? 0 : file_size;
+  preallocated_size_ = file_size_;
+  if (!read_only_) {
+    io_backend_ = DiskIOBackend::Create(io_backend);
+    double_write_buffer_ = NewAlignedPages(1 + DISK_WRITE_BATCH_PAGES);
+    // a crash may have torn pages that the metadata below is read from
+    RepairTornPages();
+  } else if (file_size_ > 0) {
+    void *mapping = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, db_fd_, 0);
+    if (mapping == MAP_FAILED) {
+      LOG(ERROR) << "Can not map db file " << db_file << ": " << strerror(errno);
+      close(db_fd_);
       throw std::exception();
     }
+    mapping_ = static_cast<const char *>(mapping);
+  }
+  bool ok = ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->IsEmpty()) {
+    meta_page->magic_ = DiskFileMetaPage::MAGIC;
+    meta_page->version_ = DiskFileMetaPage::FORMAT_VERSION;
+    meta_dirty_ = !read_only_;
+  } else if (meta_page->magic_ != DiskFileMetaPage::MAGIC || meta_page->version_ != DiskFileMetaPage::FORMAT_VERSION) {
+    // checked before the checksum, the meta page of a version 1 file has none
+    LOG(ERROR) << "Db file " << db_file << " is of format version "
+               << (meta_page->magic_ == DiskFileMetaPage::MAGIC ? meta_page->version_ : 1) << ", only version "
+               << DiskFileMetaPage::FORMAT_VERSION << " can be read";
+    ok = false;
+  }
+  // the bitmaps stay in memory, allocation never reads them again
+  for (uint32_t i = 0; ok && i < meta_page->num_extents_; i++) {
+    bitmaps_.emplace_back(new BitmapPage<PAGE_SIZE>());
+    ok = ReadPhysicalPage(BitmapPageId(i), reinterpret_cast<char *>(bitmaps_.back().get()));
+    UpdateFreeExtent(i);
+  }
+  if (!ok) {
+    // allocating from a damaged bitmap would hand out pages in use
+    LOG(ERROR) << "Can not open db file " << db_file << ", its page allocation metadata can not be used";
+    io_backend_.reset();
+    if (mapping_ != nullptr) {
+      munmap(const_cast<char *>(mapping_), file_size_);
+    }
+    close(db_fd_);
+    throw std::exception();
   }
-  ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  bitmap_dirty_.assign(bitmaps_.size(), false);
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-  WritePhysicalPage(META_PAGE_ID, meta_data_);
-  if (!closed) {
-    db_io_.close();
-    closed = true;
+  if (closed) {
+    return;
   }
+  FlushMetadata();
+  Sync();
+  // waits for the reads and writes in flight
+  io_backend_.reset();
+  if (mapping_ != nullptr) {
+    munmap(const_cast<char *>(mapping_), file_size_);
+    mapping_ = nullptr;
+  }
+  close(db_fd_);
+  closed = true;
 }
 
-void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+bool DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
-  ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+  return ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
-} 
+}
+
+void DiskManager::SubmitRead(page_id_t logical_page_id, char *page_data, IOCallback callback) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  SubmitPhysicalRead(MapPageId(logical_page_id), page_data, std::move(callback));
+}
+
+void DiskManager::SubmitWrite(page_id_t logical_page_id, const char *page_data, IOCallback callback) {
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  SubmitPhysicalWrite(MapPageId(logical_page_id), page_data, std::move(callback));
+}
 
 /**
  * TODO: Student Implement
  */
 page_id_t DiskManager::AllocatePage() {
-  std::lock_guard<std::recursive_mutex> guard(db_io_latch_); // 保护对文件和元数据的访问
-
-    DiskFileMetaPage* meta_page_ = reinterpret_cast<DiskFileMetaPage*>(meta_data_); 
-
-    //  检查是否已分配所有可能的页面
-    if (meta_page_->num_allocated_pages_ >= MAX_VALID_PAGE_ID) {
-        LOG(WARNING) << "DiskManager::AllocatePage: All possible pages (" << MAX_VALID_PAGE_ID
-                     << ") have been allocated. Cannot allocate more.";
-        return INVALID_PAGE_ID; 
-    }
-
-    for (uint32_t i = 0; i < meta_page_->num_extents_; ++i) {
-
-        if (meta_page_->extent_used_page_[i] < DiskManager::BITMAP_SIZE) { 
-            
-            BitmapPage<PAGE_SIZE> bitmap_page_obj; // 对象在栈上
-            char* bitmap_buffer = reinterpret_cast<char*>(&bitmap_page_obj);
-
-            page_id_t physical_bitmap_page_id = 1 + i * (1 + DiskManager::BITMAP_SIZE); 
-
-            ReadPhysicalPage(physical_bitmap_page_id, bitmap_buffer);
-
-            uint32_t page_offset_in_bitmap = 0; 
- 
-            bool res = bitmap_page_obj.AllocatePage(page_offset_in_bitmap);
-            
-            // assert(res, "Allocate page failed")
-            if (!res) {
-                 LOG(ERROR) << "DiskManager::AllocatePage: BitmapPage::AllocatePage failed for extent " << i
-                           << " (physical_bitmap_page_id: " << physical_bitmap_page_id 
-                           << ") even though extent_used_page suggested space. This indicates inconsistency.";
-              
-                 continue;
-            }
-
-            meta_page_->num_allocated_pages_++;
-            meta_page_->extent_used_page_[i]++;
-            
-            // 将更新后的 bitmap_page 写回磁盘
-            WritePhysicalPage(physical_bitmap_page_id, reinterpret_cast<const char*>(bitmap_buffer));
-
-            WritePhysicalPage(0, meta_data_); // 物理页0是元数据页
-           
-            page_id_t logical_page_id = i * DiskManager::BITMAP_SIZE + page_offset_in_bitmap;
-            //LOG(INFO) << "DiskManager::AllocatePage: Successfully allocated logical page_id: " << logical_page_id;
-            return logical_page_id;
-        }
-    }
-
-    BitmapPage<PAGE_SIZE> new_bitmap_obj;
-    char* new_bitmap_buffer = reinterpret_cast<char*>(&new_bitmap_obj);
-
-    uint32_t new_page_offset_in_bitmap = 0; 
-    // 在新的 bitmap_page 中分配一个页面
-    bool alloc_res = new_bitmap_obj.AllocatePage(new_page_offset_in_bitmap); 
-    
-    if (!alloc_res || new_page_offset_in_bitmap != 0) {
-
-        return INVALID_PAGE_ID;
+  std::lock_guard<std::recursive_mutex> guard(db_io_latch_);
+  if (read_only_) {
+    LOG(ERROR) << "Can not allocate a page in read-only db file " << file_name_;
+    return INVALID_PAGE_ID;
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->num_allocated_pages_ >= MAX_VALID_PAGE_ID) {
+    LOG(WARNING) << "DiskManager::AllocatePage: All possible pages (" << MAX_VALID_PAGE_ID
+                 << ") have been allocated. Cannot allocate more.";
+    return INVALID_PAGE_ID;
+  }
+  // the first extent with free pages
+  uint32_t extent_id = meta_page->num_extents_;
+  for (size_t i = 0; i < free_extents_.size(); i++) {
+    if (free_extents_[i] != 0) {
+      extent_id = static_cast<uint32_t>(i * 64 + __builtin_ctzll(free_extents_[i]));
+      break;
     }
-    uint32_t new_extent_index = meta_page_->num_extents_; // 新的extent的索引
-    page_id_t new_physical_bitmap_page_id = 1 + new_extent_index * (1 + DiskManager::BITMAP_SIZE); 
-    // 将新的 bitmap_page 写回磁盘
-    WritePhysicalPage(new_physical_bitmap_page_id, reinterpret_cast<const char*>(new_bitmap_buffer));
-
-    meta_page_->num_allocated_pages_++;
-    meta_page_->extent_used_page_[new_extent_index] = 1; // 新 extent 中已用1页
-    meta_page_->num_extents_++;
-    
-   
-    WritePhysicalPage(0, meta_data_);
-
-    page_id_t logical_page_id = new_extent_index * DiskManager::BITMAP_SIZE + new_page_offset_in_bitmap;
- 
-    return logical_page_id;
-  
+  }
+  if (extent_id == meta_page->num_extents_) {
+    // every extent is full, start a new one
+    bitmaps_.emplace_back(new BitmapPage<PAGE_SIZE>());
+    bitmap_dirty_.push_back(true);
+    meta_page->extent_used_page_[extent_id] = 0;
+    meta_page->num_extents_++;
+  }
+  uint32_t page_offset = 0;
+  if (!bitmaps_[extent_id]->AllocatePage(page_offset)) {
+    LOG(ERROR) << "DiskManager::AllocatePage: BitmapPage::AllocatePage failed for extent " << extent_id
+               << " even though extent_used_page suggested space. This indicates inconsistency.";
+    return INVALID_PAGE_ID;
+  }
+  bitmap_dirty_[extent_id] = true;
+  meta_page->num_allocated_pages_++;
+  meta_page->extent_used_page_[extent_id]++;
+  meta_dirty_ = true;
+  UpdateFreeExtent(extent_id);
+  page_id_t page_id = extent_id * BITMAP_SIZE + page_offset;
+  Preallocate(MapPageId(page_id));
+  return page_id;
 }
 
 /**
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  std::lock_guard<std::recursive_mutex> guard(db_io_latch_); // 保护对文件和元数据的访问
-
-    if (logical_page_id < 0) { // 逻辑页号通常是非负的
-        LOG(ERROR) << "DiskManager::DeAllocatePage: Attempted to deallocate an invalid logical_page_id: "
-                   << logical_page_id;
-        return;
-    }
-
-    DiskFileMetaPage* meta_page_ = reinterpret_cast<DiskFileMetaPage*>(meta_data_); 
-
-    uint32_t extent_id = static_cast<uint32_t>(logical_page_id) / DiskManager::BITMAP_SIZE;
-
-    if (extent_id >= meta_page_->num_extents_) {
-        LOG(ERROR) << "DiskManager::DeAllocatePage: Extent ID " << extent_id 
-                   << " calculated for logical_page_id " << logical_page_id
-                   << " is out of bounds. Current num_extents: " << meta_page_->num_extents_
-                   << ". Page likely not allocated or invalid ID.";
-        return;
-    }
-
-    page_id_t physical_bitmap_page_id = 1 + extent_id * (1 + DiskManager::BITMAP_SIZE);
- 
-    BitmapPage<PAGE_SIZE> bitmap_page_obj;
-    char* bitmap_buffer = reinterpret_cast<char*>(&bitmap_page_obj);
-
-    ReadPhysicalPage(physical_bitmap_page_id, bitmap_buffer);
-
-    // 计算页面在 bitmap_page 中的偏移量
-    uint32_t page_offset_in_bitmap = static_cast<uint32_t>(logical_page_id) % DiskManager::BITMAP_SIZE;
-
-    // 在 bitmap_page 中释放页面
-    bool res = bitmap_page_obj.DeAllocatePage(page_offset_in_bitmap);
-
-    if (res) {
-    
-        if (meta_page_->num_allocated_pages_ > 0) { // 防止下溢
-            meta_page_->num_allocated_pages_--;
-        } else {
-           // LOG(WARNING) << "DiskManager::DeAllocatePage: num_allocated_pages_ was already 0 before decrementing for logical_page_id " << logical_page_id;
-        }
-        if (meta_page_->extent_used_page_[extent_id] > 0) { // 防止下溢
-             meta_page_->extent_used_page_[extent_id]--;
-        } else {
-           // LOG(WARNING) << "DiskManager::DeAllocatePage: extent_used_page_[" << extent_id << "] was already 0 before decrementing for logical_page_id " << logical_page_id;
-        }
-
-        WritePhysicalPage(physical_bitmap_page_id, reinterpret_cast<const char*>(bitmap_buffer));
+  std::lock_guard<std::recursive_mutex> guard(db_io_latch_);
+  if (logical_page_id < 0) {
+    LOG(ERROR) << "DiskManager::DeAllocatePage: Attempted to deallocate an invalid logical_page_id: "
+               << logical_page_id;
+    return;
+  }
+  if (read_only_) {
+    LOG(ERROR) << "Can not deallocate page " << logical_page_id << " of read-only db file " << file_name_;
+    return;
+  }
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = static_cast<uint32_t>(logical_page_id) / BITMAP_SIZE;
+  if (extent_id >= meta_page->num_extents_) {
+    LOG(ERROR) << "DiskManager::DeAllocatePage: Extent ID " << extent_id << " calculated for logical_page_id "
+               << logical_page_id << " is out of bounds. Current num_extents: " << meta_page->num_extents_
+               << ". Page likely not allocated or invalid ID.";
+    return;
+  }
+  // the page might have already been free
+  if (!bitmaps_[extent_id]->DeAllocatePage(static_cast<uint32_t>(logical_page_id) % BITMAP_SIZE)) {
+    return;
+  }
+  bitmap_dirty_[extent_id] = true;
+  if (meta_page->num_allocated_pages_ > 0) {
+    meta_page->num_allocated_pages_--;
+  }
+  if (meta_page->extent_used_page_[extent_id] > 0) {
+    meta_page->extent_used_page_[extent_id]--;
+  }
+  meta_dirty_ = true;
+  UpdateFreeExtent(extent_id);
+}
 
-        WritePhysicalPage(0, meta_data_); 
+void DiskManager::Preallocate(page_id_t physical_page_id) {
+  uint64_t begin = static_cast<uint64_t>(physical_page_id) * PAGE_SIZE;
+  if (preallocate_pages_ == 0 || begin + PAGE_SIZE <= preallocated_size_) {
+    return;
+  }
+  begin = std::max(begin, preallocated_size_);
+  uint64_t end = begin + static_cast<uint64_t>(preallocate_pages_) * PAGE_SIZE;
+  // keep the file size, reads past it are answered with zeros without going to disk
+  if (fallocate(db_fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(begin), static_cast<off_t>(end - begin)) != 0) {
+    LOG(WARNING) << "Can not preallocate " << file_name_ << ", the file grows page by page: " << strerror(errno);
+    preallocate_pages_ = 0;
+    return;
+  }
+  preallocated_size_ = end;
+  // a file that keeps growing reserves larger chunks, up to an extent at a time
+  preallocate_pages_ = std::max(preallocate_pages_, std::min<uint32_t>(2 * preallocate_pages_, 1 + BITMAP_SIZE));
+}
 
-    } else {
-        // LOG(WARNING) << "DiskManager::DeAllocatePage: BitmapPage::DeAllocatePage failed for logical_page_id "
-        //              << logical_page_id << " (offset " << page_offset_in_bitmap << " in extent " << extent_id 
-        //              << "). The page might have already been free.";
-    }
+void DiskManager::UpdateFreeExtent(uint32_t extent_id) {
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (free_extents_.size() <= extent_id / 64) {
+    free_extents_.resize(extent_id / 64 + 1, 0);
+  }
+  uint64_t bit = uint64_t{1} << (extent_id % 64);
+  if (meta_page->extent_used_page_[extent_id] < BITMAP_SIZE) {
+    free_extents_[extent_id / 64] |= bit;
+  } else {
+    free_extents_[extent_id / 64] &= ~bit;
+  }
 }
 
 /**
  * TODO: Student Implement
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
+  std::lock_guard<std::recursive_mutex> guard(db_io_latch_);
+  if (logical_page_id < 0) {
+    LOG(WARNING) << "DiskManager::IsPageFree: Called with invalid (negative) logical_page_id: " << logical_page_id;
+    return false;
+  }
+  uint32_t extent_id = static_cast<uint32_t>(logical_page_id) / BITMAP_SIZE;
+  // an extent that does not exist yet is all free
+  if (extent_id >= bitmaps_.size()) {
+    return true;
+  }
+  return bitmaps_[extent_id]->IsPageFree(static_cast<uint32_t>(logical_page_id) % BITMAP_SIZE);
+}
 
-    std::lock_guard<std::recursive_mutex> guard(db_io_latch_);
-
-    // 增加对 logical_page_id 的基本有效性检查 
-    if (logical_page_id < 0) {
-        LOG(WARNING) << "DiskManager::IsPageFree: Called with invalid (negative) logical_page_id: " 
-                     << logical_page_id;
-        return false; // 或 true，取决于如何定义无效ID的“空闲”状态，但false更安全
-    }
-
-    // 创建一个新的 BitmapPage 对象
-    BitmapPage<PAGE_SIZE>* bitmap_page_ptr = nullptr;
-    try {
-        bitmap_page_ptr = new BitmapPage<PAGE_SIZE>();
-    } catch (const std::bad_alloc& e) {
-        LOG(FATAL) << "DiskManager::IsPageFree: Failed to allocate memory for BitmapPage: " << e.what();
-        return false; // 无法继续
-    }
-    char* bitmap_buffer = reinterpret_cast<char*>(bitmap_page_ptr);
-    // 计算页面所在的扩展 ID
-    uint32_t extent_id = static_cast<uint32_t>(logical_page_id) / DiskManager::BITMAP_SIZE;
-    //计算页面在 bitmap_page 中的偏移量
-    uint32_t page_offset_in_bitmap = static_cast<uint32_t>(logical_page_id) % DiskManager::BITMAP_SIZE;
-    //计算 bitmap_page 的物理页面 ID
-    page_id_t physical_bitmap_page_id = 1 + extent_id * (1 + DiskManager::BITMAP_SIZE);
-    // 获取元数据指针 (每次需要时进行转换，因为头文件中没有 meta_page_ 成员)
-    DiskFileMetaPage* meta_page_ptr = reinterpret_cast<DiskFileMetaPage*>(meta_data_);
-    // 检查扩展 ID 是否超出范围
-    if (extent_id >= meta_page_ptr->num_extents_) {
-        delete bitmap_page_ptr; // 清理已分配的内存
-        return true; 
+void DiskManager::FlushMetadata() {
+  std::lock_guard<std::recursive_mutex> guard(db_io_latch_);
+  if (closed) {
+    return;
+  }
+  for (size_t i = 0; i < bitmaps_.size(); i++) {
+    if (bitmap_dirty_[i]) {
+      WritePhysicalPage(BitmapPageId(i), reinterpret_cast<const char *>(bitmaps_[i].get()));
+      bitmap_dirty_[i] = false;
     }
-
-    ReadPhysicalPage(physical_bitmap_page_id, bitmap_buffer);
-
-    //检查页面是否空闲
-    bool is_free = bitmap_page_ptr->IsPageFree(page_offset_in_bitmap);
-
-    //  释放 bitmap_page 对象
-    delete bitmap_page_ptr;
-
-    //返回页面是否空闲
-    return is_free;
-
+  }
+  if (meta_dirty_) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
+    meta_dirty_ = false;
+  }
 }
 
 /**如
@@ -255,7 +277,7 @@ page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
   //  计算页面在 bitmap_page 中的偏移量
   uint32_t page_offset_in_extent_data_area = static_cast<uint32_t>(logical_page_id) % DiskManager::BITMAP_SIZE;
 
-  page_id_t physical_bitmap_page_id = 1 + extent_id * (1 + DiskManager::BITMAP_SIZE);
+  page_id_t physical_bitmap_page_id = BitmapPageId(extent_id);
 
   //  返回物理页面 ID
   page_id_t physical_page_id_as_per_image = physical_bitmap_page_id + page_offset_in_extent_data_area + 1;
@@ -270,39 +292,330 @@ int DiskManager::GetFileSize(const std::string &file_name) {
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+bool DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
+  // the callback owns the promise, it is still in use on the I/O thread when the waiter wakes up
+  auto done = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = done->get_future();
+  SubmitPhysicalRead(physical_page_id, page_data, [done](bool ok) { done->set_value(ok); });
+  return future.get();
+}
+
+void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
+  auto done = std::make_shared<std::promise<void>>();
+  std::future<void> future = done->get_future();
+  SubmitPhysicalWrite(physical_page_id, page_data, [done](bool) { done->set_value(); });
+  future.wait();
+}
+
+void DiskManager::SubmitPhysicalRead(page_id_t physical_page_id, char *page_data, IOCallback callback) {
+  uint64_t offset = static_cast<uint64_t>(physical_page_id) * PAGE_SIZE;
+  if (ReadFromWriteBatch(physical_page_id, page_data)) {
+    if (callback) {
+      callback(true);
+    }
+    return;
+  }
   // check if read beyond file length
-  if (offset >= GetFileSize(file_name_)) {
-#ifdef ENABLE_BPM_DEBUG
-    LOG(INFO) << "Read less than a page" << std::endl;
-#endif
+  if (closed || offset >= file_size_) {
     memset(page_data, 0, PAGE_SIZE);
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
+    if (callback) {
+      callback(true);
+    }
+    return;
+  }
+  if (read_only_) {
+    // the last page of the file may be short
+    size_t read_count = std::min<uint64_t>(PAGE_SIZE, file_size_ - offset);
+    memcpy(page_data, mapping_ + offset, read_count);
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    bool ok = VerifyChecksum(physical_page_id, page_data);
+    if (callback) {
+      callback(ok);
+    }
+    return;
+  }
+  num_reads_++;
+  // direct I/O reads an unaligned buffer through a bounce page
+  char *buf = page_data;
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % PAGE_SIZE != 0) {
+    buf = NewAlignedPages(1).release();
+  }
+  auto *request = new DiskIORequest();
+  request->fd_ = db_fd_;
+  request->offset_ = offset;
+  request->buf_ = buf;
+  request->len_ = PAGE_SIZE;
+  request->done_ = [this, physical_page_id, page_data, buf, callback = std::move(callback)](ssize_t result) {
+    if (result < 0) {
+      LOG(ERROR) << "I/O error while reading: " << strerror(-result);
+    }
+    size_t read_count = result < 0 ? 0 : result;
+    if (buf != page_data) {
+      memcpy(page_data, buf, read_count);
+      AlignedPageDeleter()(buf);
+    }
     // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
     if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
       LOG(INFO) << "Read less than a page" << std::endl;
 #endif
       memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
+    bool ok = result >= 0 && VerifyChecksum(physical_page_id, page_data);
+    if (callback) {
+      callback(ok);
+    }
+  };
+  io_backend_->Submit(request);
+}
+
+void DiskManager::SubmitPhysicalWrite(page_id_t physical_page_id, const char *page_data, IOCallback callback) {
+  if (closed) {
+    LOG(ERROR) << "Can not write page " << physical_page_id << " of closed db file " << file_name_;
+    if (callback) {
+      callback(false);
+    }
+    return;
+  }
+  if (read_only_) {
+    LOG(ERROR) << "Can not write page " << physical_page_id << " of read-only db file " << file_name_;
+    if (callback) {
+      callback(false);
+    }
+    return;
+  }
+  bool full;
+  {
+    std::lock_guard<std::mutex> guard(write_batch_latch_);
+    // a page written again before the batch goes out is written once
+    auto &copy = write_batch_[physical_page_id];
+    if (copy == nullptr) {
+      copy = NewAlignedPages(1);
+    }
+    memcpy(copy.get(), page_data, PAGE_SIZE);
+    SetChecksum(copy.get());
+    full = write_batch_.size() >= DISK_WRITE_BATCH_PAGES;
+  }
+  // in WRITE_THROUGH mode the batch is written and synced before the write completes
+  if (full || write_mode_ == DiskWriteMode::WRITE_THROUGH) {
+    FlushWriteBatch();
+  }
+  if (callback) {
+    callback(true);
   }
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG(ERROR) << "I/O error while writing";
+void DiskManager::IssueWrite(page_id_t physical_page_id, const char *page_data, IOCallback callback) {
+  uint64_t offset = static_cast<uint64_t>(physical_page_id) * PAGE_SIZE;
+  num_writes_++;
+  auto *request = new DiskIORequest();
+  request->is_write_ = true;
+  request->fd_ = db_fd_;
+  request->offset_ = offset;
+  request->buf_ = const_cast<char *>(page_data);
+  request->len_ = PAGE_SIZE;
+  request->done_ = [this, offset, callback = std::move(callback)](ssize_t result) {
+    // check for I/O error
+    if (result < 0) {
+      LOG(ERROR) << "I/O error while writing: " << strerror(-result);
+    } else {
+      GrowFileSize(offset + PAGE_SIZE);
+    }
+    if (callback) {
+      callback(result == PAGE_SIZE);
+    }
+  };
+  io_backend_->Submit(request);
+}
+
+bool DiskManager::ReadFromWriteBatch(page_id_t physical_page_id, char *page_data) {
+  std::lock_guard<std::mutex> guard(write_batch_latch_);
+  // the queued copy is newer than the one being written out
+  for (auto *batch : {&write_batch_, &writing_batch_}) {
+    auto iter = batch->find(physical_page_id);
+    if (iter != batch->end()) {
+      memcpy(page_data, iter->second.get(), PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+      memset(page_data + PAGE_SIZE - PAGE_CHECKSUM_SIZE, 0, PAGE_CHECKSUM_SIZE);
+      return true;
+    }
+  }
+  return false;
+}
+
+void DiskManager::FlushWriteBatch() {
+  std::lock_guard<std::mutex> flush_guard(flush_batch_latch_);
+  {
+    std::lock_guard<std::mutex> guard(write_batch_latch_);
+    writing_batch_.swap(write_batch_);
+  }
+  if (writing_batch_.empty()) {
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
-}
\ No newline at end of file
+  // nobody changes writing_batch_ but this thread, so it is read without the latch
+  std::vector<page_id_t> page_ids;
+  for (auto &entry : writing_batch_) {
+    page_ids.push_back(entry.first);
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  // concurrent writers may have queued more pages than the double-write area holds
+  for (size_t first = 0; first < page_ids.size(); first += DISK_WRITE_BATCH_PAGES) {
+    size_t num_pages = std::min<size_t>(DISK_WRITE_BATCH_PAGES, page_ids.size() - first);
+    WriteDoubleWriteArea(&page_ids[first], num_pages);
+    std::mutex done_latch;
+    std::condition_variable done_cv;
+    size_t pending = num_pages;
+    for (size_t i = first; i < first + num_pages; i++) {
+      IssueWrite(page_ids[i], writing_batch_[page_ids[i]].get(), [&](bool) {
+        std::lock_guard<std::mutex> guard(done_latch);
+        if (--pending == 0) {
+          done_cv.notify_all();
+        }
+      });
+    }
+    {
+      std::unique_lock<std::mutex> done_lock(done_latch);
+      done_cv.wait(done_lock, [&pending] { return pending == 0; });
+    }
+    // the area is overwritten by the next batch only once these pages are safe in place
+    if (fdatasync(db_fd_) != 0) {
+      LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+    }
+  }
+  std::lock_guard<std::mutex> guard(write_batch_latch_);
+  writing_batch_.clear();
+}
+
+void DiskManager::WriteDoubleWriteArea(const page_id_t *page_ids, size_t num_pages) {
+  char *buffer = double_write_buffer_.get();
+  memset(buffer, 0, PAGE_SIZE);
+  auto *header = reinterpret_cast<DoubleWriteHeaderPage *>(buffer);
+  header->num_pages_ = num_pages;
+  for (size_t i = 0; i < num_pages; i++) {
+    header->page_ids_[i] = page_ids[i];
+    // the copies carry their checksums already
+    memcpy(buffer + (1 + i) * PAGE_SIZE, writing_batch_[page_ids[i]].get(), PAGE_SIZE);
+  }
+  SetChecksum(buffer);
+  double_writes_++;
+  uint64_t offset = static_cast<uint64_t>(DOUBLE_WRITE_PAGE_ID) * PAGE_SIZE;
+  size_t len = (1 + num_pages) * PAGE_SIZE;
+  auto done = std::make_shared<std::promise<void>>();
+  std::future<void> future = done->get_future();
+  auto *request = new DiskIORequest();
+  request->is_write_ = true;
+  request->fd_ = db_fd_;
+  request->offset_ = offset;
+  request->buf_ = buffer;
+  request->len_ = len;
+  request->done_ = [this, offset, len, done](ssize_t result) {
+    if (result < 0) {
+      LOG(ERROR) << "I/O error while writing the double-write area: " << strerror(-result);
+    } else {
+      GrowFileSize(offset + len);
+    }
+    done->set_value();
+  };
+  io_backend_->Submit(request);
+  future.wait();
+  if (fdatasync(db_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+  }
+}
+
+void DiskManager::RepairTornPages() {
+  char header_data[PAGE_SIZE];
+  char copy[PAGE_SIZE];
+  char page[PAGE_SIZE];
+  uint64_t header_offset = static_cast<uint64_t>(DOUBLE_WRITE_PAGE_ID) * PAGE_SIZE;
+  // a torn header means the crash hit the double-write itself, the pages in place were not touched yet
+  if (pread(db_fd_, header_data, PAGE_SIZE, header_offset) != PAGE_SIZE || !CheckAndClearChecksum(header_data)) {
+    return;
+  }
+  auto *header = reinterpret_cast<DoubleWriteHeaderPage *>(header_data);
+  for (uint32_t i = 0; i < header->GetPageNums() && i < DISK_WRITE_BATCH_PAGES; i++) {
+    page_id_t page_id = header->GetPageId(i);
+    uint64_t offset = static_cast<uint64_t>(page_id) * PAGE_SIZE;
+    if (pread(db_fd_, copy, PAGE_SIZE, header_offset + (1 + i) * PAGE_SIZE) != PAGE_SIZE ||
+        !CheckAndClearChecksum(copy)) {
+      continue;
+    }
+    ssize_t read_count = pread(db_fd_, page, PAGE_SIZE, offset);
+    if (read_count == PAGE_SIZE && CheckAndClearChecksum(page)) {
+      continue;
+    }
+    SetChecksum(copy);
+    if (pwrite(db_fd_, copy, PAGE_SIZE, offset) != PAGE_SIZE) {
+      LOG(ERROR) << "Can not repair page " << page_id << " of db file " << file_name_ << ": " << strerror(errno);
+      continue;
+    }
+    GrowFileSize(offset + PAGE_SIZE);
+    repaired_pages_++;
+    LOG(WARNING) << "Repaired torn page " << page_id << " of db file " << file_name_ << " from the double-write area";
+  }
+  if (repaired_pages_ > 0 && fdatasync(db_fd_) != 0) {
+    LOG(ERROR) << "I/O error while syncing: " << strerror(errno);
+  }
+}
+
+void DiskManager::GrowFileSize(uint64_t end) {
+  uint64_t file_size = file_size_;
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end)) {
+  }
+}
+
+void DiskManager::SetChecksum(char *page_data) {
+  uint32_t checksum = Crc32c(page_data, PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+  memcpy(page_data + PAGE_SIZE - PAGE_CHECKSUM_SIZE, &checksum, PAGE_CHECKSUM_SIZE);
+}
+
+bool DiskManager::CheckAndClearChecksum(char *page_data) {
+  uint32_t checksum;
+  memcpy(&checksum, page_data + PAGE_SIZE - PAGE_CHECKSUM_SIZE, PAGE_CHECKSUM_SIZE);
+  memset(page_data + PAGE_SIZE - PAGE_CHECKSUM_SIZE, 0, PAGE_CHECKSUM_SIZE);
+  if (checksum == Crc32c(page_data, PAGE_SIZE - PAGE_CHECKSUM_SIZE)) {
+    return true;
+  }
+  // a hole in the file or a preallocated page that was never written
+  return checksum == 0 && page_data[0] == 0 && memcmp(page_data, page_data + 1, PAGE_SIZE - 1) == 0;
+}
+
+bool DiskManager::VerifyChecksum(page_id_t physical_page_id, char *page_data) {
+  if (CheckAndClearChecksum(page_data)) {
+    return true;
+  }
+  checksum_failures_++;
+  LOG(ERROR) << "Checksum mismatch in page " << physical_page_id << " of db file " << file_name_;
+  return false;
+}
+
+void DiskManager::Sync() {
+  if (closed || read_only_) {
+    return;
+  }
+  // every batch is synced once it is in place
+  FlushWriteBatch();
+}
+
+void DiskManager::SetWriteMode(DiskWriteMode write_mode) {
+  Sync();
+  write_mode_ = write_mode;
+}
+
+bool DiskManager::SetDirectIO(bool enable) {
+  if (closed || read_only_) {
+    return false;
+  }
+  Sync();
+  int flags = fcntl(db_fd_, F_GETFL);
+  if (flags < 0 || fcntl(db_fd_, F_SETFL, enable ? flags | O_DIRECT : flags & ~O_DIRECT) != 0) {
+    LOG(WARNING) << "Can not use direct I/O on " << file_name_ << ", page I/O stays buffered: " << strerror(errno);
+    direct_io_ = false;
+    return false;
+  }
+  direct_io_ = enable;
+  // the cached pages of the file are never read again
+  if (enable) {
+    posix_fadvise(db_fd_, 0, 0, POSIX_FADV_DONTNEED);
+  }
+  return enable;
+}
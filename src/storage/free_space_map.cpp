@@ -0,0 +1,155 @@
+#include "storage/free_space_map.h"
+
+page_id_t FreeSpaceMap::Create(BufferPoolManager *buffer_pool_manager, page_id_t heap_page_id, uint32_t free_space) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager->NewPage(page_id);
+  if (page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  map_page->Init();
+  map_page->Append(heap_page_id, ToUnits(free_space));
+  buffer_pool_manager->UnpinPage(page_id, true);
+  return page_id;
+}
+
+bool FreeSpaceMap::Load() {
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      heap_page_ids_.clear();
+      positions_.clear();
+      tree_.clear();
+      capacity_ = 0;
+      map_page_ids_.clear();
+      return false;
+    }
+    auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    map_page_ids_.push_back(page_id);
+    for (uint32_t i = 0; i < map_page->GetCount(); i++) {
+      positions_[map_page->GetPageId(i)] = heap_page_ids_.size();
+      heap_page_ids_.push_back(map_page->GetPageId(i));
+      SetLeaf(heap_page_ids_.size() - 1, map_page->GetFreeSpace(i));
+    }
+    page_id_t next_page_id = map_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  loaded_ = true;
+  return true;
+}
+
+void FreeSpaceMap::Add(page_id_t heap_page_id, uint32_t free_space) {
+  positions_[heap_page_id] = heap_page_ids_.size();
+  heap_page_ids_.push_back(heap_page_id);
+  SetLeaf(heap_page_ids_.size() - 1, ToUnits(free_space));
+  WriteEntry(heap_page_ids_.size() - 1, ToUnits(free_space));
+}
+
+void FreeSpaceMap::Update(page_id_t heap_page_id, uint32_t free_space) {
+  auto iter = positions_.find(heap_page_id);
+  if (iter == positions_.end() || tree_[capacity_ + iter->second] == ToUnits(free_space)) {
+    return;
+  }
+  SetLeaf(iter->second, ToUnits(free_space));
+  WriteEntry(iter->second, ToUnits(free_space));
+}
+
+page_id_t FreeSpaceMap::Find(uint32_t size) const {
+  // rounded up, the recorded free space is rounded down
+  uint32_t units = (size + FreeSpaceMapPage::FREE_SPACE_UNIT - 1) / FreeSpaceMapPage::FREE_SPACE_UNIT;
+  if (capacity_ == 0 || tree_[1] < units) {
+    return INVALID_PAGE_ID;
+  }
+  size_t node = 1;
+  while (node < capacity_) {
+    node = tree_[2 * node] >= units ? 2 * node : 2 * node + 1;
+  }
+  return heap_page_ids_[node - capacity_];
+}
+
+void FreeSpaceMap::Free() {
+  for (auto page_id : map_page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  // a map that was never loaded still owns its pages
+  if (!loaded_ && first_page_id_ != INVALID_PAGE_ID) {
+    page_id_t page_id = first_page_id_;
+    while (page_id != INVALID_PAGE_ID) {
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        break;
+      }
+      page_id_t next_page_id = reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = next_page_id;
+    }
+  }
+  first_page_id_ = INVALID_PAGE_ID;
+  heap_page_ids_.clear();
+  positions_.clear();
+  tree_.clear();
+  capacity_ = 0;
+  map_page_ids_.clear();
+}
+
+void FreeSpaceMap::SetLeaf(size_t i, uint8_t free_space) {
+  if (i >= capacity_) {
+    // double the leaves and rebuild the inner nodes above them
+    size_t capacity = std::max<size_t>(capacity_ * 2, 64);
+    std::vector<uint8_t> tree(2 * capacity, 0);
+    std::copy(tree_.begin() + capacity_, tree_.end(), tree.begin() + capacity);
+    for (size_t node = capacity - 1; node >= 1; node--) {
+      tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+    }
+    tree_.swap(tree);
+    capacity_ = capacity;
+  }
+  size_t node = capacity_ + i;
+  tree_[node] = free_space;
+  for (node /= 2; node >= 1; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+void FreeSpaceMap::WriteEntry(size_t i, uint8_t free_space) {
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  size_t map_index = i / FreeSpaceMapPage::MAX_ENTRIES;
+  uint32_t slot = i % FreeSpaceMapPage::MAX_ENTRIES;
+  if (map_index == map_page_ids_.size()) {
+    // the last map page is full, chain a new one
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      return;
+    }
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    Page *last_page = buffer_pool_manager_->FetchPage(map_page_ids_.back());
+    if (last_page == nullptr) {
+      buffer_pool_manager_->DeletePage(page_id);
+      return;
+    }
+    reinterpret_cast<FreeSpaceMapPage *>(last_page->GetData())->SetNextPageId(page_id);
+    buffer_pool_manager_->UnpinPage(map_page_ids_.back(), true);
+    map_page_ids_.push_back(page_id);
+  }
+  if (map_index >= map_page_ids_.size()) {
+    return;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(map_page_ids_[map_index]);
+  if (page == nullptr) {
+    return;
+  }
+  auto *map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  if (slot < map_page->GetCount()) {
+    map_page->SetFreeSpace(slot, free_space);
+  } else if (slot == map_page->GetCount()) {
+    map_page->Append(heap_page_ids_[i], free_space);
+  }
+  buffer_pool_manager_->UnpinPage(map_page_ids_[map_index], true);
+}
@@ -3,84 +3,193 @@
 /**
  * TODO: Student Implement
  */
-bool TableHeap::InsertTuple(Row &row, Txn *txn) { 
+bool TableHeap::InsertTuple(Row &row, Txn *txn, BufferAccessStrategy *strategy) {
   if (row.GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW) {
       return false; // Tuple too large even for an empty page
   }
+  uint32_t size = row.GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
 
-  page_id_t current_page_id = first_page_id_;
-  TablePage *table_page = nullptr;
-
-  // 1. Try to find an existing page with enough space.
-  while (current_page_id != INVALID_PAGE_ID) {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(current_page_id));
-    if (page == nullptr) { return false; }
-    table_page = page;
-
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  if (!LoadFreeSpaceMap(strategy)) {
+    return false;
+  }
+  // 1. Try the pages the free-space map has room in.
+  for (page_id_t page_id = fsm_.Find(size); page_id != INVALID_PAGE_ID; page_id = fsm_.Find(size)) {
+    auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy));
+    if (table_page == nullptr) { return false; }
     table_page->WLatch();
-    if (table_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
-      table_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(current_page_id, true);
+    bool inserted = table_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    uint32_t free_space = table_page->GetFreeSpaceRemaining();
+    table_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    // a stale entry is corrected, and not offered again for a tuple of this size
+    fsm_.Update(page_id, inserted ? free_space : std::min(free_space, size - 1));
+    if (inserted) {
       return true;
     }
-    table_page->WUnlatch();
-
-    page_id_t next_page_id = table_page->GetNextPageId();
-    buffer_pool_manager_->UnpinPage(current_page_id, false);
-    current_page_id = next_page_id;
   }
 
   // 2. If no existing page works, create a new one.
-  page_id_t new_page_id;
-  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-  if (new_page == nullptr) { return false; }
-  table_page = new_page;
-
-  // Find the last page ID to link.
-  page_id_t last_page_id = first_page_id_;
-  page_id_t prev_page_id_for_new = INVALID_PAGE_ID;
+  return AppendPage(row, txn, strategy);
+}
 
-  if (last_page_id == new_page_id) { // This means the heap was empty
-      prev_page_id_for_new = INVALID_PAGE_ID;
-  } else {
-      page_id_t current_iter_id = last_page_id;
-      while(true) {
-          auto iter_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(current_iter_id));
-          if (iter_page == nullptr) { // Error
-              buffer_pool_manager_->UnpinPage(new_page_id, false);
-              buffer_pool_manager_->DeletePage(new_page_id);
-              return false;
-          }
-          page_id_t next_id = iter_page->GetNextPageId();
-          buffer_pool_manager_->UnpinPage(current_iter_id, false);
-          if (next_id == INVALID_PAGE_ID) {
-              prev_page_id_for_new = current_iter_id; // Found the last one
-              break;
-          }
-          current_iter_id = next_id;
-      }
-      // Link the last page to the new page.
-      auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id_for_new));
-      if (last_page == nullptr) { // Error
-            buffer_pool_manager_->UnpinPage(new_page_id, false);
-            buffer_pool_manager_->DeletePage(new_page_id);
-            return false;
+bool TableHeap::LoadFreeSpaceMap(BufferAccessStrategy *strategy) {
+  if (fsm_.IsLoaded()) {
+    return true;
+  }
+  if (!fsm_.Load()) {
+    return false;
+  }
+  if (fsm_.GetFirstPageId() == INVALID_PAGE_ID) {
+    // no map on disk, walk the chain once
+    for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+      auto table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, strategy));
+      if (table_page == nullptr) {
+        fsm_ = FreeSpaceMap(buffer_pool_manager_, INVALID_PAGE_ID);
+        return false;
       }
-      last_page->WLatch();
-      last_page->SetNextPageId(new_page_id);
-      last_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(prev_page_id_for_new, true);
+      table_page->RLatch();
+      fsm_.Add(page_id, table_page->GetFreeSpaceRemaining());
+      page_id_t next_page_id = table_page->GetNextPageId();
+      table_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
   }
+  page_count_ = fsm_.GetPageCount();
+  return true;
+}
+
+page_id_t TableHeap::FindLastPage(BufferAccessStrategy *strategy) {
+  page_id_t last_page_id = fsm_.GetLastPageId();
+  // pages linked after the last one the map knows of, if the map was not written back before a crash
+  while (true) {
+    auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id, strategy));
+    if (last_page == nullptr) { return INVALID_PAGE_ID; }
+    page_id_t next_page_id = last_page->GetNextPageId();
+    if (last_page_id != fsm_.GetLastPageId()) {
+      fsm_.Add(last_page_id, last_page->GetFreeSpaceRemaining());
+    }
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return last_page_id;
+    }
+    last_page_id = next_page_id;
+  }
+}
+
+bool TableHeap::AppendPage(Row &row, Txn *txn, BufferAccessStrategy *strategy) {
+  page_id_t last_page_id = FindLastPage(strategy);
+  if (last_page_id == INVALID_PAGE_ID) { return false; }
+  page_id_t new_page_id;
+  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id, strategy));
+  if (new_page == nullptr) { return false; }
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id, strategy));
+  if (last_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(new_page_id, false);
+    buffer_pool_manager_->DeletePage(new_page_id);
+    return false;
+  }
+  // Link the last page to the new page.
+  last_page->WLatch();
+  last_page->SetNextPageId(new_page_id);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
 
   // Initialize and insert into the new page.
-  table_page->WLatch();
-  table_page->Init(new_page_id, prev_page_id_for_new, log_manager_, txn);
-  bool success = table_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
-  table_page->WUnlatch();
+  new_page->WLatch();
+  new_page->Init(new_page_id, last_page_id, log_manager_, txn);
+  bool success = new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_space = new_page->GetFreeSpaceRemaining();
+  new_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(new_page_id, true);
+  fsm_.Add(new_page_id, free_space);
+  page_count_ = fsm_.GetPageCount();
 
   return success;
+}
+
+bool TableHeap::BulkInsert(RowBatch &batch, Txn *txn, BufferAccessStrategy *strategy) {
+  batch.GetRowIds().clear();
+  for (size_t i = 0; i < batch.Size(); i++) {
+    if (batch.GetRow(i).GetSerializedSize(schema_) > TablePage::SIZE_MAX_ROW) {
+      return false;
+    }
+  }
+  if (batch.Empty()) {
+    return true;
+  }
 
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  if (!LoadFreeSpaceMap(strategy)) {
+    return false;
+  }
+  page_id_t last_page_id = FindLastPage(strategy);
+  if (last_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  // the new pages are filled before anyone can reach them, so they are not latched
+  std::vector<std::pair<page_id_t, uint32_t>> new_pages;
+  TablePage *page = nullptr;
+  bool success = true;
+  for (size_t i = 0; i < batch.Size(); i++) {
+    Row &row = batch.GetRow(i);
+    if (page != nullptr && page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_)) {
+      batch.GetRowIds().push_back(row.GetRowId());
+      continue;
+    }
+    // the page is full, start the next one
+    page_id_t new_page_id;
+    auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id, strategy));
+    if (new_page == nullptr) {
+      success = false;
+      break;
+    }
+    new_page->Init(new_page_id, new_pages.empty() ? last_page_id : new_pages.back().first, log_manager_, txn);
+    if (page != nullptr) {
+      page->SetNextPageId(new_page_id);
+      new_pages.back().second = page->GetFreeSpaceRemaining();
+      buffer_pool_manager_->UnpinPage(new_pages.back().first, true);
+    }
+    new_pages.emplace_back(new_page_id, 0);
+    page = new_page;
+    page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    batch.GetRowIds().push_back(row.GetRowId());
+  }
+  if (page != nullptr) {
+    new_pages.back().second = page->GetFreeSpaceRemaining();
+    buffer_pool_manager_->UnpinPage(new_pages.back().first, true);
+  }
+  if (new_pages.empty()) {
+    return false;
+  }
+
+  // Link the new pages after the last page in one step.
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id, strategy));
+  if (last_page == nullptr) {
+    for (auto &new_page : new_pages) {
+      buffer_pool_manager_->DeletePage(new_page.first);
+    }
+    batch.GetRowIds().clear();
+    return false;
+  }
+  last_page->WLatch();
+  last_page->SetNextPageId(new_pages.front().first);
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  for (auto &new_page : new_pages) {
+    fsm_.Add(new_page.first, new_page.second);
+  }
+  page_count_ = fsm_.GetPageCount();
+
+  return success;
+}
+
+void TableHeap::UpdateFreeSpace(page_id_t page_id, uint32_t free_space) {
+  std::lock_guard<std::mutex> guard(fsm_latch_);
+  if (LoadFreeSpaceMap(nullptr)) {
+    fsm_.Update(page_id, free_space);
+  }
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Txn *txn) {
@@ -120,6 +229,7 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
   page->WLatch();
 
   int update_res = page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
 
   // 处理返回值
@@ -127,6 +237,7 @@ bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Txn *txn) {
     //  原地更新成功
     row.SetRowId(rid); // 确保 RowId 是旧的 RowId
     buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true); // 页面变脏
+    UpdateFreeSpace(rid.GetPageId(), free_space);
     return true;
   } else if (update_res == 3) {
   
@@ -172,9 +283,11 @@ void TableHeap::ApplyDelete(const RowId &rid, Txn *txn) {
   // Step2: Delete the tuple from the page.
   table_page->WLatch(); // 增加了并发控制的闩锁
   table_page->ApplyDelete(rid, txn, log_manager_); 
+  uint32_t free_space = table_page->GetFreeSpaceRemaining();
   table_page->WUnlatch(); // 释放闩锁
 
   buffer_pool_manager_->UnpinPage(table_page->GetTablePageId(), true); //  (true 表示已修改)
+  UpdateFreeSpace(rid.GetPageId(), free_space);
 }
 
 void TableHeap::RollbackDelete(const RowId &rid, Txn *txn) {
@@ -218,35 +331,42 @@ void TableHeap::DeleteTable(page_id_t page_id) {
     buffer_pool_manager_->DeletePage(page_id);
   } else {
     DeleteTable(first_page_id_);
+    fsm_.Free();
   }
 }
 
 /**
  * TODO: Student Implement
  */
-TableIterator TableHeap::Begin(Txn *txn) { 
+TableIterator TableHeap::Begin(Txn *txn, BufferAccessStrategy *strategy) {
   page_id_t current_page_id = first_page_id_;
   RowId first_rid;
+  uint32_t pages_visited = 0;
 
   // 循环遍历页面，直到找到第一个包含有效元组的页面
   while (current_page_id != INVALID_PAGE_ID) {
-    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(current_page_id));
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(current_page_id, strategy));
     if (page == nullptr) {
       return End(); // 如果无法获取页面，则返回 End 迭代器
     }
     page_id_t next_page_id = page->GetNextPageId(); // 先获取下一页 ID
+    pages_visited++;
 
     if (page->GetFirstTupleRid(&first_rid)) { // 尝试从当前页获取第一个元组的 RID
       buffer_pool_manager_->UnpinPage(current_page_id, false);
-      return TableIterator(this, first_rid, txn); // 找到，返回指向该元组的迭代器
+      TableIterator iter(this, first_rid, txn, strategy); // 找到，返回指向该元组的迭代器
+      iter.pages_visited_ = pages_visited;
+      iter.ReadAhead(next_page_id);
+      return iter;
     }
 
     // 当前页面没有有效元组，Unpin 并继续下一页
     buffer_pool_manager_->UnpinPage(current_page_id, false);
     current_page_id = next_page_id;
   }
+  page_count_ = pages_visited;
 
-  return End(); // 遍历完所有页面都没有找到元组 
+  return End(); // 遍历完所有页面都没有找到元组
 }
 /**
  * TODO: Student Implement
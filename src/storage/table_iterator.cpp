@@ -6,8 +6,8 @@
 /**
  * TODO: Student Implement
  */
-TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn) 
-:table_heap_(table_heap), rid_(rid), txn_(txn){
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Txn *txn, BufferAccessStrategy *strategy)
+:table_heap_(table_heap), rid_(rid), txn_(txn), strategy_(strategy){
   if (table_heap_ != nullptr && rid_.GetPageId() != INVALID_PAGE_ID) {
         row_ = Row(rid_); 
         if (!table_heap_->GetTuple(&row_, txn_)) {
@@ -20,11 +20,18 @@ TableIterator::TableIterator(const TableIterator &other) {
   table_heap_ = other.table_heap_;
     rid_ = other.rid_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    pages_visited_ = other.pages_visited_;
     row_ = other.row_;
 }
 
 TableIterator::~TableIterator() = default;
 
+void TableIterator::ReadAhead(page_id_t next_page_id) {
+  table_heap_->buffer_pool_manager_->Prefetch(
+      next_page_id, [](Page *page) { return reinterpret_cast<TablePage *>(page)->GetNextPageId(); }, strategy_);
+}
+
 bool TableIterator::operator==(const TableIterator &itr) const {
   return table_heap_ == itr.table_heap_ && rid_ == itr.rid_;
 }
@@ -48,6 +55,8 @@ TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
         table_heap_ = itr.table_heap_;
         rid_ = itr.rid_;
         txn_ = itr.txn_;
+        strategy_ = itr.strategy_;
+        pages_visited_ = itr.pages_visited_;
         row_ = itr.row_;
     }
     return *this;
@@ -66,7 +75,7 @@ TableIterator &TableIterator::operator++() {
     RowId next_rid;
 
     // 获取当前页面
-    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(current_page_id));
+    auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(current_page_id, strategy_));
     if (page == nullptr) {
         // 无法获取当前页面，这是一个异常情况，设置为 End()
         rid_.Set(INVALID_PAGE_ID, 0);
@@ -89,18 +98,25 @@ TableIterator &TableIterator::operator++() {
 
         if (next_page_id == INVALID_PAGE_ID) {
             // 没有下一页了，到达末尾
+            if (pages_visited_ != 0) {
+                table_heap_->page_count_ = pages_visited_;
+            }
             rid_.Set(INVALID_PAGE_ID, 0);
             return *this;
         }
 
         // 移动到下一页
         current_page_id = next_page_id;
-        page = reinterpret_cast<TablePage *>(bpm->FetchPage(current_page_id));
+        page = reinterpret_cast<TablePage *>(bpm->FetchPage(current_page_id, strategy_));
         if (page == nullptr) {
             // 无法获取下一页，设为 End()
             rid_.Set(INVALID_PAGE_ID, 0);
             return *this;
         }
+        if (pages_visited_ != 0) {
+            pages_visited_++;
+        }
+        ReadAhead(page->GetNextPageId());
 
         // 尝试从新页面的开头获取第一个元组
         if (page->GetFirstTupleRid(&next_rid)) {
@@ -0,0 +1,51 @@
+#include "storage/table_scanner.h"
+
+#include "storage/table_heap.h"
+
+TableScanner::TableScanner(TableHeap *table_heap, Txn *txn, BufferAccessStrategy *strategy)
+    : table_heap_(table_heap), txn_(txn), strategy_(strategy) {
+  FetchPage(table_heap_->first_page_id_);
+}
+
+TableScanner::~TableScanner() {
+  if (page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+  }
+}
+
+void TableScanner::FetchPage(page_id_t page_id) {
+  slot_ = 0;
+  if (page_id == INVALID_PAGE_ID) {
+    table_heap_->page_count_ = pages_visited_;
+    return;
+  }
+  page_ = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(page_id, strategy_));
+  if (page_ == nullptr) {
+    // no frame to read the page into, the scan ends here as a TableIterator does
+    return;
+  }
+  pages_visited_++;
+  table_heap_->buffer_pool_manager_->Prefetch(
+      page_->GetNextPageId(), [](Page *page) { return reinterpret_cast<TablePage *>(page)->GetNextPageId(); },
+      strategy_);
+}
+
+bool TableScanner::Next() {
+  while (page_ != nullptr) {
+    // the slot count is read every time, the caller may have inserted into the page since
+    while (slot_ < page_->GetTupleCount()) {
+      uint32_t slot = slot_++;
+      const char *data = page_->GetTupleData(slot);
+      if (data != nullptr) {
+        view_.Reset(data, table_heap_->schema_, RowId(page_->GetTablePageId(), slot));
+        return true;
+      }
+    }
+    page_id_t page_id = page_->GetTablePageId();
+    page_id_t next_page_id = page_->GetNextPageId();
+    table_heap_->buffer_pool_manager_->UnpinPage(page_id, false);
+    page_ = nullptr;
+    FetchPage(next_page_id);
+  }
+  return false;
+}
@@ -1,9 +1,18 @@
 #include "buffer/buffer_pool_manager.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 
 TEST(BufferPoolManagerTest, BinaryDataTest) {
@@ -34,6 +43,8 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
   // Insert terminal characters both in the middle and at end
   random_binary_data[PAGE_SIZE / 2] = '\0';
   random_binary_data[PAGE_SIZE - 1] = '\0';
+  // The end of the page holds its checksum on disk and reads back as zeros
+  memset(random_binary_data + PAGE_SIZE - PAGE_CHECKSUM_SIZE, 0, PAGE_CHECKSUM_SIZE);
 
   // Scenario: Once we have a page, we should be able to read and write content.
   std::memcpy(page0->GetData(), random_binary_data, PAGE_SIZE);
@@ -71,4 +82,569 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+
+TEST(BufferPoolManagerTest, ShardedConcurrentTest) {
+  const std::string db_name = "bpm_sharded_test.db";
+  const size_t buffer_pool_size = 64;
+  const size_t num_instances = 4;
+  const int num_threads = 4;
+  const int pages_per_thread = 200;
+
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, num_instances);
+  ASSERT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: threads create and write pages concurrently, every page is hashed to one of the shards.
+  std::vector<std::vector<page_id_t>> page_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = bpm->NewPage(page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+        page_ids[t].push_back(page_id);
+        ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  // Scenario: pages evicted from their shard are read back from disk with the data written before.
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (auto page_id : page_ids[t]) {
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: a shard is full once all of its frames are pinned, even though other shards have room.
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < buffer_pool_size / num_instances; i++) {
+    page_id_t page_id = static_cast<page_id_t>(i * num_instances);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    pinned.push_back(page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(static_cast<page_id_t>(buffer_pool_size)));
+  EXPECT_NE(nullptr, bpm->FetchPage(1));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  for (auto page_id : pinned) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ReplacerPolicyTest) {
+  const std::string db_name = "bpm_policy_test.db";
+  const size_t buffer_pool_size = 10;
+
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK}) {
+    remove(db_name.c_str());
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 1, replacer_type);
+    EXPECT_EQ(replacer_type, bpm->GetReplacerType());
+
+    // Scenario: write more pages than the pool holds, then read them all back through evictions.
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < buffer_pool_size * 3; i++) {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), PAGE_SIZE, "page-%d", page_id);
+      page_ids.push_back(page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    for (auto page_id : page_ids) {
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page-" + std::to_string(page_id), std::string(page->GetData()));
+      ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+
+    // Scenario: pinned pages are never chosen as victims.
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[buffer_pool_size]));
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+
+    delete bpm;
+    delete disk_manager;
+    remove(db_name.c_str());
+  }
+}
+
+/**
+ * DiskManager whose reads and writes take a fixed amount of time, to make a miss visibly slower than a hit.
+ */
+class SlowDiskManager : public DiskManager {
+ public:
+  SlowDiskManager(const std::string &db_file, std::chrono::milliseconds read_delay,
+                  std::chrono::milliseconds write_delay = std::chrono::milliseconds(0))
+      : DiskManager(db_file), read_delay_(read_delay), write_delay_(write_delay) {}
+
+  bool ReadPage(page_id_t logical_page_id, char *page_data) override {
+    read_count_++;
+    std::this_thread::sleep_for(read_delay_);
+    return DiskManager::ReadPage(logical_page_id, page_data);
+  }
+
+  void WritePage(page_id_t logical_page_id, const char *page_data) override {
+    write_count_++;
+    std::this_thread::sleep_for(write_delay_);
+    DiskManager::WritePage(logical_page_id, page_data);
+  }
+
+  std::atomic<int> read_count_{0};
+  std::atomic<int> write_count_{0};
+
+ private:
+  std::chrono::milliseconds read_delay_;
+  std::chrono::milliseconds write_delay_;
+};
+
+TEST(BufferPoolManagerTest, HitDuringMissTest) {
+  const std::string db_name = "bpm_io_test.db";
+  const size_t buffer_pool_size = 8;
+  const auto read_delay = std::chrono::milliseconds(50);
+
+  remove(db_name.c_str());
+  auto *disk_manager = new SlowDiskManager(db_name, read_delay);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Prepare a hot page that stays resident and enough cold pages to force misses.
+  page_id_t hot_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(hot_page_id));
+  const int cold_pages = 16;
+  std::vector<page_id_t> cold_page_ids;
+  for (int i = 0; i < cold_pages; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    snprintf(bpm->FetchPage(page_id)->GetData(), PAGE_SIZE, "cold-%d", page_id);
+    bpm->UnpinPage(page_id, true);
+    bpm->UnpinPage(page_id, true);
+    cold_page_ids.push_back(page_id);
+  }
+
+  auto measure_hits = [&](int rounds) {
+    std::vector<double> latencies;
+    for (int i = 0; i < rounds; i++) {
+      auto start = std::chrono::steady_clock::now();
+      Page *page = bpm->FetchPage(hot_page_id);
+      auto stop = std::chrono::steady_clock::now();
+      EXPECT_NE(nullptr, page);
+      bpm->UnpinPage(hot_page_id, false);
+      latencies.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return *std::max_element(latencies.begin(), latencies.end());
+  };
+  double idle_max = measure_hits(20);
+
+  // Scenario: a thread keeps missing on cold pages, each miss holds a frame for the duration of the disk read.
+  std::atomic<bool> stop{false};
+  std::thread miss_thread([&] {
+    for (int i = 0; !stop; i = (i + 1) % cold_pages) {
+      Page *page = bpm->FetchPage(cold_page_ids[i]);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("cold-" + std::to_string(cold_page_ids[i]), std::string(page->GetData()));
+      bpm->UnpinPage(cold_page_ids[i], false);
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  double busy_max = measure_hits(100);
+  stop = true;
+  miss_thread.join();
+
+  // Hits on the resident page never wait for the disk read of another page.
+  LOG(INFO) << "max hit latency idle: " << idle_max << " ms, during misses: " << busy_max << " ms";
+  EXPECT_GT(disk_manager->read_count_, 2);
+  EXPECT_LT(busy_max, read_delay.count() / 2.0);
+
+  // Scenario: concurrent fetches of the same missing page share one disk read.
+  page_id_t shared_page_id = cold_page_ids[0];
+  for (auto page_id : cold_page_ids) {
+    if (page_id == shared_page_id) continue;
+    bpm->FetchPage(page_id);
+    bpm->UnpinPage(page_id, false);
+  }
+  int reads_before = disk_manager->read_count_;
+  std::vector<Page *> fetched(4, nullptr);
+  std::vector<std::thread> fetchers;
+  for (size_t i = 0; i < fetched.size(); i++) {
+    fetchers.emplace_back([&, i] { fetched[i] = bpm->FetchPage(shared_page_id); });
+  }
+  for (auto &fetcher : fetchers) {
+    fetcher.join();
+  }
+  EXPECT_EQ(reads_before + 1, disk_manager->read_count_);
+  for (auto page : fetched) {
+    ASSERT_EQ(fetched[0], page);
+    EXPECT_EQ("cold-" + std::to_string(shared_page_id), std::string(page->GetData()));
+    bpm->UnpinPage(shared_page_id, false);
+  }
+
+  bpm->UnpinPage(hot_page_id, false);
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, AccessStrategyTest) {
+  const std::string db_name = "bpm_strategy_test.db";
+  const size_t buffer_pool_size = 32;
+  const int hot_pages = 16;
+  const int scan_pages = 200;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: create the scanned pages through a bulk write ring, then the hot pages.
+  BufferAccessStrategy bulk_write(AccessStrategyType::BULK_WRITE, 4);
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (int i = 0; i < scan_pages + hot_pages; i++) {
+    Page *page = i < scan_pages ? bpm->NewPage(page_id, &bulk_write) : bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: the hot pages survived the bulk write and a sequential scan through a ring.
+  BufferPoolStats before = bpm->GetStats();
+  BufferAccessStrategy scan(AccessStrategyType::SEQUENTIAL_SCAN, 4);
+  for (int i = 0; i < scan_pages; i++) {
+    Page *page = bpm->FetchPage(page_ids[i], &scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  BufferPoolStats after = bpm->GetStats();
+  // only the last pages written through the bulk write ring are still cached
+  EXPECT_EQ(scan_pages - bulk_write.GetRingSize(), after.misses_ - before.misses_);
+  for (int i = scan_pages; i < scan_pages + hot_pages; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(after.misses_, bpm->GetStats().misses_);
+
+  // Scenario: a frame of the ring that is pinned by someone else is not reused.
+  Page *pinned = bpm->FetchPage(page_ids[scan_pages - 1]);
+  ASSERT_NE(nullptr, pinned);
+  for (int i = 0; i < 8; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i], &scan));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(page_ids[scan_pages - 1], pinned->GetPageId());
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[scan_pages - 1], false));
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "bpm_prefetch_test.db";
+  const size_t buffer_pool_size = 16;
+  const int chain_length = 64;
+  const size_t window = 8;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  bpm->SetPrefetchWindow(window);
+  auto next_page = [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); };
+
+  // Scenario: build a chain of pages that does not fit into the pool, every page links to the next one.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (int i = 0; i < chain_length; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    page_ids.push_back(page_id);
+  }
+  for (int i = 0; i < chain_length; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = i + 1 < chain_length ? page_ids[i + 1] : INVALID_PAGE_ID;
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // Scenario: read the head of the chain ahead and wait for the worker.
+  BufferPoolStats before = bpm->GetStats();
+  bpm->Prefetch(page_ids[0], next_page);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (bpm->GetStats().prefetches_ - before.prefetches_ < window && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(window, bpm->GetStats().prefetches_ - before.prefetches_);
+
+  // Scenario: fetching the pages read ahead does not miss.
+  for (size_t i = 0; i < window; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_ids[i + 1], next_page(page));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  BufferPoolStats after = bpm->GetStats();
+  EXPECT_EQ(before.misses_, after.misses_);
+  EXPECT_EQ(window, after.prefetch_hits_ - before.prefetch_hits_);
+
+  // Scenario: a window of 0 disables read-ahead.
+  bpm->SetPrefetchWindow(0);
+  bpm->Prefetch(page_ids[window], next_page);
+  Page *page = bpm->FetchPage(page_ids[window]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[window], false));
+  EXPECT_EQ(after.prefetches_, bpm->GetStats().prefetches_);
+  EXPECT_EQ(after.misses_ + 1, bpm->GetStats().misses_);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const std::string db_name = "bpm_bg_writer_test.db";
+  const size_t buffer_pool_size = 32;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2);
+  bpm->SetDirtyRatioThreshold(0.25);
+
+  // Scenario: dirty the whole pool, keep one page pinned.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    if (i > 0) {
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    page_ids.push_back(page_id);
+  }
+  EXPECT_EQ(buffer_pool_size - 1, bpm->GetStats().dirty_pages_);
+
+  // Scenario: the background writer cleans unpinned pages down to the threshold.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  // a write-back counts once it is on disk, the page is clean from the moment it is submitted
+  while ((bpm->GetStats().dirty_pages_ > buffer_pool_size / 4 ||
+          bpm->GetStats().background_writes_ < buffer_pool_size - 1 - buffer_pool_size / 4) &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size / 4, stats.dirty_pages_);
+  EXPECT_EQ(buffer_pool_size - 1 - buffer_pool_size / 4, stats.background_writes_);
+
+  // Scenario: the cleaned pages are on disk, the pinned one is not.
+  char data[PAGE_SIZE];
+  int on_disk = 0;
+  for (auto id : page_ids) {
+    disk_manager->ReadPage(id, data);
+    on_disk += std::string(data) == "page " + std::to_string(id);
+  }
+  EXPECT_EQ(stats.background_writes_, on_disk);
+  disk_manager->ReadPage(page_ids[0], data);
+  EXPECT_EQ(std::string(), std::string(data));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, FlushAllPagesTest) {
+  const std::string db_name = "bpm_flush_all_test.db";
+  const size_t buffer_pool_size = 16;
+  const auto write_delay = std::chrono::milliseconds(20);
+  remove(db_name.c_str());
+  auto *disk_manager = new SlowDiskManager(db_name, std::chrono::milliseconds(0), write_delay);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  // only the checkpoint writes in this test
+  bpm->SetDirtyRatioThreshold(1.0);
+
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: fetches go on while a checkpoint writes the pool.
+  int writes_before = disk_manager->write_count_;
+  std::thread checkpoint([&] { bpm->FlushAllPages(); });
+  std::this_thread::sleep_for(write_delay);
+  double max_latency = 0;
+  for (int round = 0; round < 4; round++) {
+    for (auto id : page_ids) {
+      auto start = std::chrono::steady_clock::now();
+      Page *page = bpm->FetchPage(id);
+      auto stop = std::chrono::steady_clock::now();
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(id, false));
+      max_latency = std::max(max_latency, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+  }
+  checkpoint.join();
+  EXPECT_LT(max_latency, write_delay.count() / 2.0);
+  EXPECT_EQ(writes_before + static_cast<int>(buffer_pool_size), disk_manager->write_count_);
+  EXPECT_EQ(0, bpm->GetStats().dirty_pages_);
+
+  // Scenario: every page is on disk.
+  char data[PAGE_SIZE];
+  for (auto id : page_ids) {
+    disk_manager->DiskManager::ReadPage(id, data);
+    EXPECT_EQ("page " + std::to_string(id), std::string(data));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "bpm_resize_test.db";
+  const size_t buffer_pool_size = 16;
+  const size_t max_pool_size = 64;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, 2, ReplacerType::LRU, max_pool_size);
+  bpm->SetDirtyRatioThreshold(1.0);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+
+  // Scenario: a grown pool holds as many pages as it has frames.
+  EXPECT_EQ(max_pool_size, bpm->Resize(max_pool_size * 2));
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (size_t i = 0; i < max_pool_size; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  for (auto id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(id, true));
+  }
+
+  // Scenario: shrinking writes the dirty pages of the retired frames back.
+  EXPECT_EQ(buffer_pool_size, bpm->Resize(buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size, bpm->GetStats().dirty_pages_);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  for (auto id : page_ids) {
+    Page *page = bpm->FetchPage(id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(id, false));
+  }
+
+  // Scenario: a pinned page stops shrinking, the pool keeps its frame.
+  bpm->Resize(max_pool_size);
+  std::vector<Page *> pinned;
+  for (auto id : page_ids) {
+    pinned.push_back(bpm->FetchPage(id));
+    ASSERT_NE(nullptr, pinned.back());
+  }
+  EXPECT_EQ(max_pool_size, bpm->Resize(buffer_pool_size));
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(2, bpm->Resize(0));
+  EXPECT_EQ(buffer_pool_size, bpm->Resize(buffer_pool_size));
+
+  // Scenario: the pool works at its new size.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(page_id));
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolManagerTest, ChecksumFailureTest) {
+  const std::string db_name = "bpm_checksum_test.db";
+  const size_t buffer_pool_size = 2;
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 2; i++) {
+    Page *page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+  // page 0 alone goes out last, the double-write area keeps no copy of page 1 to repair it from
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  delete bpm;
+  delete disk_manager;
+
+  // Scenario: a byte of page 1 flips on disk.
+  int fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  char byte = 'z';
+  ASSERT_EQ(1, pwrite(fd, &byte, 1, (DiskManager::FIRST_EXTENT_PAGE_ID + 2) * PAGE_SIZE + 100));
+  close(fd);
+
+  // Scenario: the damaged page is not fetched, prefetched or kept in a frame.
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  EXPECT_EQ(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(1, disk_manager->GetIOStats().checksum_failures_);
+  bpm->Prefetch(1);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (disk_manager->GetIOStats().checksum_failures_ < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(nullptr, bpm->FetchPage(1));
+  EXPECT_EQ(3, disk_manager->GetIOStats().checksum_failures_);
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+
+  // Scenario: the pool still has all its frames for the intact pages.
+  Page *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 0", std::string(page->GetData()));
+  ASSERT_NE(nullptr, bpm->NewPage(page_id));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
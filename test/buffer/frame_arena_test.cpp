@@ -0,0 +1,48 @@
+#include "buffer/frame_arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(FrameArenaTest, AlignmentTest) {
+  const size_t num_frames = 1000;
+  FrameArena arena(num_frames);
+  EXPECT_EQ(num_frames, arena.GetNumFrames());
+  // Scenario: the arena starts on a huge page, every frame on a page.
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrame(0)) % HUGE_PAGE_SIZE);
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrame(i)) % PAGE_SIZE);
+    EXPECT_EQ(PAGE_SIZE, arena.GetFrame(i + 1) - arena.GetFrame(i));
+  }
+  // Scenario: frames read as zeros before they are written and keep what is written.
+  char zeros[PAGE_SIZE] = {0};
+  EXPECT_EQ(0, memcmp(zeros, arena.GetFrame(num_frames - 1), PAGE_SIZE));
+  for (size_t i = 0; i < num_frames; i++) {
+    snprintf(arena.GetFrame(i), PAGE_SIZE, "frame %zu", i);
+  }
+  for (size_t i = 0; i < num_frames; i++) {
+    EXPECT_EQ("frame " + std::to_string(i), std::string(arena.GetFrame(i)));
+  }
+}
+
+TEST(FrameArenaTest, ReleaseTest) {
+  const size_t num_frames = 2 * HUGE_PAGE_SIZE / PAGE_SIZE;
+  FrameArena arena(num_frames);
+  for (size_t i = 0; i < num_frames; i++) {
+    snprintf(arena.GetFrame(i), PAGE_SIZE, "frame %zu", i);
+  }
+  // Scenario: released frames read as zeros, the others are kept.
+  arena.Release(num_frames / 2, num_frames);
+  for (size_t i = 0; i < num_frames / 2; i++) {
+    EXPECT_EQ("frame " + std::to_string(i), std::string(arena.GetFrame(i)));
+  }
+  for (size_t i = num_frames / 2; i < num_frames; i++) {
+    EXPECT_EQ(std::string(), std::string(arena.GetFrame(i)));
+  }
+  // Scenario: the buffer pool's pages are cache line aligned.
+  EXPECT_EQ(0, alignof(Page) % CACHE_LINE_SIZE);
+  EXPECT_EQ(0, sizeof(Page) % CACHE_LINE_SIZE);
+}
@@ -0,0 +1,66 @@
+#include "buffer/lru_k_replacer.h"
+
+#include "gtest/gtest.h"
+
+TEST(LRUKReplacerTest, SampleTest) {
+  // no correlated period, every access counts
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+
+  // Scenario: access 1, 2, 3, 4 once, then 1 and 2 a second time.
+  for (frame_id_t frame_id : {1, 2, 3, 4, 1, 2}) {
+    lru_k_replacer.Pin(frame_id);
+  }
+  for (frame_id_t frame_id : {1, 2, 3, 4}) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(4, lru_k_replacer.Size());
+
+  // Scenario: frames with less than K accesses go first, then the oldest second-to-last access.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: a pinned frame is not a victim, unpinning it again keeps its history.
+  lru_k_replacer.Pin(1);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+
+  // Scenario: the replacer is empty.
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 2);
+
+  // Scenario: a scan touches 1 five times in a row, that is a single access.
+  for (frame_id_t frame_id : {1, 1, 1, 1, 1, 2, 3, 4, 2, 5}) {
+    lru_k_replacer.Pin(frame_id);
+  }
+  for (frame_id_t frame_id : {1, 2, 3, 4, 5}) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+
+  // Scenario: 2 has two uncorrelated accesses and outlives the others. Once only frames inside their correlated
+  // period are left, the regular order applies.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+
+  // Scenario: a removed frame is forgotten.
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+/**
+ * The previous LRUReplacer: a std::list plus an unordered_set, Pin removes from the list in O(n).
+ */
+class ListLRUReplacer : public Replacer {
+ public:
+  explicit ListLRUReplacer(size_t num_pages) : capacity_(num_pages) {}
+
+  bool Victim(frame_id_t *frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (lru_list_.empty()) {
+      return false;
+    }
+    *frame_id = lru_list_.back();
+    lru_list_.pop_back();
+    lru_set_tracker_.erase(*frame_id);
+    return true;
+  }
+
+  void Pin(frame_id_t frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (lru_set_tracker_.count(frame_id)) {
+      lru_set_tracker_.erase(frame_id);
+      lru_list_.remove(frame_id);
+    }
+  }
+
+  void Unpin(frame_id_t frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (lru_set_tracker_.find(frame_id) == lru_set_tracker_.end() && capacity_ > 0) {
+      lru_list_.push_front(frame_id);
+      lru_set_tracker_.insert(frame_id);
+    }
+  }
+
+  size_t Size() override {
+    std::lock_guard<std::mutex> guard(latch_);
+    return lru_list_.size();
+  }
+
+  void Resize(size_t num_pages) override { capacity_ = num_pages; }
+
+ private:
+  std::list<frame_id_t> lru_list_;
+  std::unordered_set<frame_id_t> lru_set_tracker_;
+  std::mutex latch_;
+  size_t capacity_;
+};
+
+/**
+ * Buffer pool access pattern on a full pool: every frame starts unpinned, then each step is either a hit on a random
+ * unpinned frame (Pin + Unpin) or a miss (Victim + Unpin of the reused frame).
+ * @return nanoseconds per step
+ */
+static double RunReplacerWorkload(Replacer *replacer, size_t num_frames, size_t steps) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<frame_id_t> frame_dist(0, static_cast<frame_id_t>(num_frames - 1));
+  for (size_t i = 0; i < num_frames; i++) {
+    replacer->Unpin(static_cast<frame_id_t>(i));
+  }
+  std::vector<frame_id_t> hits(steps);
+  for (auto &frame_id : hits) {
+    frame_id = frame_dist(rng);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < steps; i++) {
+    if (i % 4 == 3) {
+      frame_id_t victim;
+      replacer->Victim(&victim);
+      replacer->Unpin(victim);
+    } else {
+      replacer->Pin(hits[i]);
+      replacer->Unpin(hits[i]);
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+  EXPECT_EQ(num_frames, replacer->Size());
+  return std::chrono::duration<double, std::nano>(stop - start).count() / steps;
+}
+
+TEST(LRUReplacerBench, ListVsIntrusive) {
+  printf("%10s %10s %16s %16s %10s %16s\n", "frames", "steps", "list (ns/op)", "array (ns/op)", "speedup",
+         "clock (ns/op)");
+  for (size_t num_frames : {1000UL, 20480UL, 1000000UL}) {
+    // keep the O(n) list replacer within a few seconds at 1M frames
+    size_t steps = std::max<size_t>(200, std::min<size_t>(1000000, 400000000UL / num_frames));
+    ListLRUReplacer list_replacer(num_frames);
+    LRUReplacer array_replacer(num_frames);
+    double list_ns = RunReplacerWorkload(&list_replacer, num_frames, steps);
+    double array_ns = RunReplacerWorkload(&array_replacer, num_frames, steps);
+    CLOCKReplacer clock_replacer(num_frames);
+    double clock_ns = RunReplacerWorkload(&clock_replacer, num_frames, steps);
+    printf("%10zu %10zu %16.1f %16.1f %9.1fx %16.1f\n", num_frames, steps, list_ns, array_ns, list_ns / array_ns,
+           clock_ns);
+  }
+}
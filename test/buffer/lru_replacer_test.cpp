@@ -40,4 +40,31 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(6, value);
   lru_replacer.Victim(&value);
   EXPECT_EQ(4, value);
+}
+
+TEST(LRUReplacerTest, ResizeTest) {
+  LRUReplacer lru_replacer(4);
+  lru_replacer.Unpin(2);
+  lru_replacer.Unpin(0);
+  lru_replacer.Unpin(3);
+  lru_replacer.Pin(3);
+
+  // Scenario: a grown replacer keeps the order of its frames and takes the new ones.
+  lru_replacer.Resize(8);
+  lru_replacer.Unpin(7);
+  EXPECT_EQ(3, lru_replacer.Size());
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+
+  // Scenario: so does a shrunk one.
+  lru_replacer.Pin(7);
+  lru_replacer.Unpin(1);
+  lru_replacer.Resize(2);
+  EXPECT_EQ(2, lru_replacer.Size());
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(lru_replacer.Victim(&value));
 }
\ No newline at end of file
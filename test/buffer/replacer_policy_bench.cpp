@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "replacer_policy_bench.db";
+
+static const size_t kLoadPoolSize = 16384;
+static const size_t kPoolSize = 512;
+static const int kRowNums = 100000;
+static const int kHotKeys = 4000;          // point lookups hit ids [0, kHotKeys)
+static const int kScanLookupStride = 100;  // one point lookup every kScanLookupStride scanned tuples
+static const int kLookups = 20000;
+
+struct PolicyResult {
+  double warm_hit_ratio_;
+  double scan_hit_ratio_;
+  double after_scan_hit_ratio_;
+};
+
+static std::vector<Column *> MakeColumns() {
+  return {new Column("id", TypeId::kTypeInt, 0, false, false), new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+          new Column("account", TypeId::kTypeFloat, 2, true, false)};
+}
+
+/**
+ * Build the table and its index on id with a pool large enough to hold both.
+ * @return the first page of the table heap
+ */
+static page_id_t LoadDatabase() {
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(kLoadPoolSize, disk_mgr);
+  page_id_t id;
+  // keep the catalog pages allocated like a real database does
+  bpm->NewPage(id);
+  bpm->UnpinPage(id, true);
+  bpm->NewPage(id);
+  bpm->UnpinPage(id, true);
+  TableSchema table_schema(MakeColumns());
+  std::vector<uint32_t> index_key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, key_schema, 16, bpm);
+  TableHeap *table_heap = TableHeap::Create(bpm, &table_schema, nullptr, nullptr, nullptr);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  for (int i = 0; i < kRowNums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i))};
+    Row row(fields);
+    EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    EXPECT_EQ(DB_SUCCESS, index->InsertEntry(key, row.GetRowId(), nullptr));
+  }
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  delete index;
+  delete table_heap;
+  delete key_schema;
+  delete bpm;
+  delete disk_mgr;
+  return first_page_id;
+}
+
+/**
+ * Point lookups through the B+ tree on a hot key range, then a full sequential scan of the table heap interleaved
+ * with lookups, then lookups again. Only the buffer pool hits and misses of the lookups are counted.
+ */
+static PolicyResult RunPolicyWorkload(ReplacerType replacer_type, page_id_t first_page_id) {
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(kPoolSize, disk_mgr, 1, replacer_type);
+  TableSchema table_schema(MakeColumns());
+  std::vector<uint32_t> index_key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, key_schema, 16, bpm);
+  TableHeap *table_heap = TableHeap::Create(bpm, first_page_id, &table_schema, nullptr, nullptr);
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> key_dist(0, kHotKeys - 1);
+  uint64_t hits = 0, misses = 0;
+  auto lookup = [&]() {
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, key_dist(rng))};
+    Row key(key_fields);
+    std::vector<RowId> result;
+    BufferPoolStats before = bpm->GetStats();
+    EXPECT_EQ(DB_SUCCESS, index->ScanKey(key, result, nullptr));
+    BufferPoolStats after = bpm->GetStats();
+    hits += after.hits_ - before.hits_;
+    misses += after.misses_ - before.misses_;
+  };
+  auto hit_ratio = [&]() {
+    double ratio = hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses);
+    hits = misses = 0;
+    return ratio;
+  };
+
+  PolicyResult result{};
+  for (int i = 0; i < kLookups; i++) {
+    lookup();
+  }
+  result.warm_hit_ratio_ = hit_ratio();
+  int scanned = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+    if (++scanned % kScanLookupStride == 0) {
+      lookup();
+    }
+  }
+  EXPECT_EQ(kRowNums, scanned);
+  result.scan_hit_ratio_ = hit_ratio();
+  for (int i = 0; i < kLookups; i++) {
+    lookup();
+  }
+  result.after_scan_hit_ratio_ = hit_ratio();
+
+  delete index;
+  delete table_heap;
+  delete key_schema;
+  delete bpm;
+  delete disk_mgr;
+  return result;
+}
+
+TEST(ReplacerPolicyBench, ScanWithPointLookups) {
+  printf("pool %zu frames, %d rows, lookups on ids [0, %d), one lookup every %d scanned tuples\n", kPoolSize, kRowNums,
+         kHotKeys, kScanLookupStride);
+  printf("%8s %16s %16s %16s\n", "policy", "warm hit %", "during scan %", "after scan %");
+  page_id_t first_page_id = LoadDatabase();
+  std::pair<const char *, ReplacerType> policies[] = {
+      {"LRU", ReplacerType::LRU}, {"CLOCK", ReplacerType::CLOCK}, {"LRU-K", ReplacerType::LRU_K}};
+  for (auto &policy : policies) {
+    PolicyResult result = RunPolicyWorkload(policy.second, first_page_id);
+    printf("%8s %16.2f %16.2f %16.2f\n", policy.first, result.warm_hit_ratio_ * 100, result.scan_hit_ratio_ * 100,
+           result.after_scan_hit_ratio_ * 100);
+  }
+  remove(db_name.c_str());
+}
@@ -66,6 +66,14 @@ TEST(CatalogTest, CatalogTableTest) {
   ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_02->GetTable("table-2", table_info_03));
   ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-1", table_info_03));
   delete db_02;
+  /** Stage 3: Testing read-only loading */
+  auto db_03 = new DBStorageEngine(db_file_name, false, DEFAULT_BUFFER_POOL_SIZE, DEFAULT_BUFFER_POOL_INSTANCES,
+                                   ReplacerType::LRU, true);
+  ASSERT_TRUE(db_03->disk_mgr_->IsReadOnly());
+  TableInfo *table_info_04 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_03->catalog_mgr_->GetTable("table-1", table_info_04));
+  EXPECT_EQ(0, db_03->disk_mgr_->GetIOStats().reads_);
+  delete db_03;
 }
 
 TEST(CatalogTest, CatalogIndexTest) {
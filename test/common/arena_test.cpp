@@ -0,0 +1,108 @@
+#include "common/arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+TEST(ArenaTest, AllocateTest) {
+  Arena arena;
+  ASSERT_EQ(Arena::INLINE_BLOCK_SIZE, arena.GetCapacity());
+  // small allocations come from the inline block, aligned as asked
+  for (size_t alignment : {1, 2, 4, 8, 16}) {
+    auto p = static_cast<char *>(arena.allocate(3, alignment));
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(p) % alignment);
+    memset(p, 'x', 3);
+  }
+  ASSERT_EQ(Arena::INLINE_BLOCK_SIZE, arena.GetCapacity());
+
+  // an allocation larger than a block gets a block of its own
+  auto mark = arena.GetMark();
+  auto large = static_cast<char *>(arena.allocate(Arena::BLOCK_SIZE * 2));
+  memset(large, 'y', Arena::BLOCK_SIZE * 2);
+  size_t capacity = arena.GetCapacity();
+  ASSERT_GT(capacity, Arena::INLINE_BLOCK_SIZE + Arena::BLOCK_SIZE * 2);
+
+  // blocks are kept for reuse after a rewind
+  arena.Rewind(mark);
+  std::vector<int *> ints;
+  for (int i = 0; i < 20000; i++) {
+    ints.push_back(arena.New<int>(i));
+  }
+  for (int i = 0; i < 20000; i++) {
+    ASSERT_EQ(i, *ints[i]);
+  }
+  ASSERT_EQ(capacity, arena.GetCapacity());
+  arena.Reset();
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(arena.allocate(1 << 20, 64)) % 64);
+}
+
+TEST(ArenaTest, RowTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[] = "minisql";
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeChar, name, strlen(name), false),
+                               Field(TypeId::kTypeFloat)};
+  Arena arena;
+  Arena other_arena;
+
+  // fields and their data are copied into the arena
+  Row row(&arena);
+  for (auto &field : fields) {
+    row.AddField(field);
+  }
+  name[0] = 'M';
+  ASSERT_EQ("minisql", row.GetField(1)->toString());
+  auto begin = reinterpret_cast<const char *>(&arena);
+  ASSERT_TRUE(row.GetField(1)->GetData() >= begin && row.GetField(1)->GetData() < begin + sizeof(arena));
+
+  // a copy stays in the same arena, an assigned row in its own
+  Row copy(row);
+  ASSERT_EQ(&arena, copy.GetArena());
+  Row heap_row;
+  heap_row = row;
+  Row other_row(&other_arena);
+  other_row = std::move(copy);
+  ASSERT_EQ(&other_arena, other_row.GetArena());
+  for (auto r : {&heap_row, &other_row}) {
+    ASSERT_EQ(3, r->GetFieldCount());
+    ASSERT_EQ(CmpBool::kTrue, r->GetField(0)->CompareEquals(fields[0]));
+    ASSERT_EQ("minisql", r->GetField(1)->toString());
+    ASSERT_TRUE(r->GetField(2)->IsNull());
+  }
+  ASSERT_NE(row.GetField(1)->GetData(), heap_row.GetField(1)->GetData());
+  ASSERT_NE(row.GetField(1)->GetData(), other_row.GetField(1)->GetData());
+
+  // a row read into the arena
+  char buffer[PAGE_SIZE];
+  uint32_t size = heap_row.SerializeTo(buffer, schema.get());
+  auto mark = arena.GetMark();
+  Row read_row(RowId(1, 2), &arena);
+  ASSERT_EQ(size, read_row.DeserializeFrom(buffer, schema.get()));
+  ASSERT_EQ(RowId(1, 2), read_row.GetRowId());
+  ASSERT_EQ(CmpBool::kTrue, read_row.GetField(0)->CompareEquals(fields[0]));
+  ASSERT_EQ("minisql", read_row.GetField(1)->toString());
+  ASSERT_TRUE(read_row.GetField(2)->IsNull());
+
+  // a key row made from it is in the arena of the key row
+  std::vector<Column *> key_columns = {new Column("name", TypeId::kTypeChar, 64, 0, true, false)};
+  Schema key_schema(key_columns);
+  Row key_row(&other_arena);
+  read_row.GetKeyFromRow(schema.get(), &key_schema, key_row);
+  ASSERT_EQ(1, key_row.GetFieldCount());
+  ASSERT_EQ("minisql", key_row.GetField(0)->toString());
+
+  // a destroyed row keeps nothing in the arena, what it took can be rewound
+  read_row.destroy();
+  ASSERT_EQ(0, read_row.GetFieldCount());
+  arena.Rewind(mark);
+  read_row.DeserializeFrom(buffer, schema.get());
+  ASSERT_EQ(3, read_row.GetFieldCount());
+  ASSERT_EQ("minisql", row.GetField(1)->toString());
+}
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/copy_loader.h"
+#include "gtest/gtest.h"
+
+static const std::string db_name = "copy_bench.db";
+static const std::string csv_name = "copy_bench.csv";
+static const std::string binary_name = "copy_bench.bin";
+
+// rows loaded, COPY_BENCH_ROWS in the environment overrides it
+static const int kRowNums = 10000000;
+static const int kBlockRows = 4096;
+
+static int RowNums() {
+  const char *rows = getenv("COPY_BENCH_ROWS");
+  return rows != nullptr ? atoi(rows) : kRowNums;
+}
+
+static std::unique_ptr<DBStorageEngine> CreateTable(TableInfo *&table_info, IndexInfo *&index_info) {
+  auto db = std::make_unique<DBStorageEngine>(db_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  db->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info);
+  std::vector<std::string> index_keys{"id"};
+  db->catalog_mgr_->CreateIndex("t", "t_id", index_keys, nullptr, index_info, "bptree");
+  return db;
+}
+
+static long FileSize(const std::string &file_name) {
+  std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+  return in.tellg();
+}
+
+/**
+ * Load the same rows into a table with a unique index three ways: one row at a time through TableHeap::InsertTuple and
+ * Index::InsertEntry as INSERT does, and with COPY from a CSV and from a binary file, which parse on worker threads,
+ * insert through TableHeap::BulkInsert and build the index at the end. Prints the rows and megabytes per second.
+ */
+TEST(CopyBench, Load) {
+  int rows = RowNums();
+  {
+    std::ofstream csv(csv_name);
+    std::ofstream binary(binary_name, std::ios::binary);
+    TableInfo *table_info;
+    IndexInfo *index_info;
+    auto db = CreateTable(table_info, index_info);
+    CopyLoader::WriteBinaryHeader(binary, table_info->GetSchema());
+    std::vector<Row> block;
+    char name[32];
+    // ids in a scattered order, so the index does not get them sorted
+    for (int i = 0; i < rows; i++) {
+      int id = static_cast<int>((static_cast<int64_t>(i) * 7919) % rows);
+      int len = snprintf(name, sizeof(name), "customer-%d", id);
+      float account = static_cast<float>(id % 10000) / 4;
+      csv << id << ',' << name << ',' << account << '\n';
+      std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, len, true),
+                                Field(TypeId::kTypeFloat, account)};
+      block.emplace_back(fields);
+      if (block.size() == kBlockRows || i == rows - 1) {
+        CopyLoader::WriteBinaryBlock(binary, block, table_info->GetSchema());
+        block.clear();
+      }
+    }
+  }
+  printf("%d rows, csv %.1f MB, binary %.1f MB, %u hardware threads\n", rows, FileSize(csv_name) / 1e6,
+         FileSize(binary_name) / 1e6, std::thread::hardware_concurrency());
+  printf("%16s %10s %12s %10s\n", "path", "sec", "rows/sec", "MB/sec");
+
+  for (const char *path : {"row at a time", "copy csv", "copy binary"}) {
+    TableInfo *table_info;
+    IndexInfo *index_info;
+    auto db = CreateTable(table_info, index_info);
+    auto start = std::chrono::steady_clock::now();
+    std::string file_name = path == std::string("copy binary") ? binary_name : csv_name;
+    if (path == std::string("row at a time")) {
+      std::ifstream in(csv_name);
+      std::string line;
+      std::string name;
+      std::string account;
+      while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string id;
+        std::getline(ss, id, ',');
+        std::getline(ss, name, ',');
+        std::getline(ss, account, ',');
+        std::vector<Field> fields{Field(TypeId::kTypeInt, std::stoi(id)),
+                                  Field(TypeId::kTypeChar, name.data(), static_cast<uint32_t>(name.size()), true),
+                                  Field(TypeId::kTypeFloat, std::stof(account))};
+        Row row(fields);
+        ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+        std::vector<Field> key_fields{Field(TypeId::kTypeInt, std::stoi(id))};
+        Row key(key_fields);
+        ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key, row.GetRowId(), nullptr));
+      }
+    } else {
+      auto exec_ctx = db->MakeExecuteContext(nullptr);
+      CopyLoader loader(exec_ctx.get(), table_info, {index_info});
+      CopyFormat format = file_name == binary_name ? CopyFormat::BINARY : CopyFormat::CSV;
+      ASSERT_EQ(DB_SUCCESS, loader.Load(file_name, format)) << loader.GetError();
+      ASSERT_EQ(rows, loader.GetRowCount());
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%16s %10.2f %12.0f %10.1f\n", path, sec, rows / sec, FileSize(file_name) / 1e6 / sec);
+  }
+  remove(("./databases/" + db_name).c_str());
+  remove(csv_name.c_str());
+  remove(binary_name.c_str());
+}
@@ -0,0 +1,270 @@
+#include "executor/copy_loader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+static const std::string db_name = "copy_loader_test.db";
+static const std::string csv_name = "copy_loader_test.csv";
+static const std::string binary_name = "copy_loader_test.bin";
+
+class CopyLoaderTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    db_ = new DBStorageEngine(db_name, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("name", TypeId::kTypeChar, 16, 1, true, false),
+                                     new Column("account", TypeId::kTypeFloat, 2, true, false)};
+    auto schema = std::make_shared<Schema>(columns);
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info_));
+    std::vector<std::string> index_keys{"id"};
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateIndex("t", "t_id", index_keys, nullptr, index_info_, "bptree"));
+    exec_ctx_ = db_->MakeExecuteContext(nullptr);
+  }
+
+  void TearDown() override {
+    exec_ctx_.reset();
+    delete db_;
+    remove(("./databases/" + db_name).c_str());
+    remove(csv_name.c_str());
+    remove(binary_name.c_str());
+  }
+
+  size_t CountRows() {
+    size_t count = 0;
+    for (auto it = table_info_->GetTableHeap()->Begin(nullptr); it != table_info_->GetTableHeap()->End(); ++it) {
+      count++;
+    }
+    return count;
+  }
+
+  /** @return the row id the index has for the key, an invalid one if none */
+  RowId Lookup(int32_t id) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    Row key(fields);
+    std::vector<RowId> result;
+    index_info_->GetIndex()->ScanKey(key, result, nullptr);
+    return result.empty() ? RowId() : result[0];
+  }
+
+ protected:
+  DBStorageEngine *db_{nullptr};
+  TableInfo *table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+  std::unique_ptr<ExecuteContext> exec_ctx_;
+};
+
+TEST_F(CopyLoaderTest, CsvTest) {
+  // enough rows for several segments, with quoting, nulls, CRLF and blank lines on the way
+  const int rows = 100000;
+  {
+    std::ofstream out(csv_name);
+    for (int i = 0; i < rows; i++) {
+      if (i % 3 == 0) {
+        out << i << ",\"a,\"\"b\"\"\"," << i * 0.5f << "\r\n";
+      } else if (i % 3 == 1) {
+        out << i << ",," << "\n\n";
+      } else {
+        out << i << ",name" << i % 100 << "," << i << "\n";
+      }
+    }
+  }
+  CopyLoader loader(exec_ctx_.get(), table_info_, {index_info_}, 3);
+  ASSERT_EQ(DB_SUCCESS, loader.Load(csv_name, CopyFormat::CSV)) << loader.GetError();
+  ASSERT_EQ(rows, loader.GetRowCount());
+  ASSERT_EQ(rows, CountRows());
+  for (int i : {0, 1, 2, rows / 2, rows - 1}) {
+    RowId row_id = Lookup(i);
+    ASSERT_NE(INVALID_PAGE_ID, row_id.GetPageId());
+    Row row(row_id);
+    ASSERT_TRUE(table_info_->GetTableHeap()->GetTuple(&row, nullptr));
+    ASSERT_EQ(kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+    if (i % 3 == 0) {
+      ASSERT_EQ("a,\"b\"", row.GetField(1)->toString());
+      ASSERT_EQ(kTrue, row.GetField(2)->CompareEquals(Field(TypeId::kTypeFloat, i * 0.5f)));
+    } else if (i % 3 == 1) {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+      ASSERT_TRUE(row.GetField(2)->IsNull());
+    } else {
+      ASSERT_EQ("name" + std::to_string(i % 100), row.GetField(1)->toString());
+    }
+  }
+}
+
+TEST_F(CopyLoaderTest, BinaryTest) {
+  const int blocks = 20;
+  const int block_rows = 1000;
+  {
+    std::ofstream out(binary_name, std::ios::binary);
+    CopyLoader::WriteBinaryHeader(out, table_info_->GetSchema());
+    char name[] = "binary";
+    for (int b = 0; b < blocks; b++) {
+      std::vector<Row> rows;
+      for (int i = b * block_rows; i < (b + 1) * block_rows; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 6, true),
+                                  Field(TypeId::kTypeFloat)};
+        rows.emplace_back(fields);
+      }
+      CopyLoader::WriteBinaryBlock(out, rows, table_info_->GetSchema());
+    }
+  }
+  CopyLoader loader(exec_ctx_.get(), table_info_, {index_info_}, 2);
+  ASSERT_EQ(DB_SUCCESS, loader.Load(binary_name, CopyFormat::BINARY)) << loader.GetError();
+  ASSERT_EQ(blocks * block_rows, loader.GetRowCount());
+  ASSERT_EQ(blocks * block_rows, CountRows());
+  RowId row_id = Lookup(blocks * block_rows - 1);
+  Row row(row_id);
+  ASSERT_TRUE(table_info_->GetTableHeap()->GetTuple(&row, nullptr));
+  ASSERT_EQ("binary", row.GetField(1)->toString());
+  ASSERT_TRUE(row.GetField(2)->IsNull());
+
+  // a CSV file is not a binary one
+  {
+    std::ofstream out(csv_name);
+    out << "1,a,1\n";
+  }
+  ASSERT_EQ(DB_FAILED, loader.Load(csv_name, CopyFormat::BINARY));
+  ASSERT_EQ(blocks * block_rows, CountRows());
+
+  // a row whose null bitmap or char field runs past its block is refused before it is read
+  std::ostringstream block;
+  char name[] = "binary";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, name, 6, true),
+                            Field(TypeId::kTypeFloat)};
+  CopyLoader::WriteBinaryBlock(block, {Row(fields)}, table_info_->GetSchema());
+  std::string long_name = block.str();
+  // row count, block size, field count, null bitmap, id, then the length of the name
+  uint32_t name_len = 0x7fffffff;
+  memcpy(&long_name[3 * sizeof(uint32_t) + 1 + sizeof(int32_t)], &name_len, sizeof(name_len));
+  std::string short_bitmap(3 * sizeof(uint32_t), '\0');
+  uint32_t header[] = {1, sizeof(uint32_t), table_info_->GetSchema()->GetColumnCount()};
+  memcpy(&short_bitmap[0], header, sizeof(header));
+  for (const auto &data : {long_name, short_bitmap}) {
+    {
+      std::ofstream out(binary_name, std::ios::binary);
+      CopyLoader::WriteBinaryHeader(out, table_info_->GetSchema());
+      out << data;
+    }
+    ASSERT_EQ(DB_FAILED, loader.Load(binary_name, CopyFormat::BINARY));
+    ASSERT_EQ("row 1: malformed row", loader.GetError());
+  }
+  ASSERT_EQ(blocks * block_rows, CountRows());
+
+  // a char value longer than its column is refused, an index keyed on the column is sized by its length
+  std::vector<Column *> short_columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                         new Column("name", TypeId::kTypeChar, 4, 1, false, true)};
+  auto short_schema = std::make_shared<Schema>(short_columns);
+  TableInfo *short_table;
+  ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("u", short_schema.get(), nullptr, short_table));
+  IndexInfo *name_index;
+  std::vector<std::string> name_keys{"name"};
+  ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateIndex("u", "u_name", name_keys, nullptr, name_index, "bptree"));
+  {
+    std::ofstream out(binary_name, std::ios::binary);
+    CopyLoader::WriteBinaryHeader(out, short_table->GetSchema());
+    char short_name[] = "ab";
+    char long_name[] = "abcdefgh";
+    std::vector<Field> first{Field(TypeId::kTypeInt, 1), Field(TypeId::kTypeChar, short_name, 2, true)};
+    std::vector<Field> second{Field(TypeId::kTypeInt, 2), Field(TypeId::kTypeChar, long_name, 8, true)};
+    CopyLoader::WriteBinaryBlock(out, {Row(first), Row(second)}, short_table->GetSchema());
+  }
+  CopyLoader short_loader(exec_ctx_.get(), short_table, {name_index}, 2);
+  ASSERT_EQ(DB_FAILED, short_loader.Load(binary_name, CopyFormat::BINARY));
+  ASSERT_EQ("row 2: value too long for column name", short_loader.GetError());
+  ASSERT_TRUE(short_table->GetTableHeap()->Begin(nullptr) == short_table->GetTableHeap()->End());
+}
+
+TEST_F(CopyLoaderTest, FailedLoadTest) {
+  {
+    std::ofstream out(csv_name);
+    out << "1,a,1\n2,b,2\n";
+  }
+  CopyLoader loader(exec_ctx_.get(), table_info_, {index_info_}, 2);
+  ASSERT_EQ(DB_SUCCESS, loader.Load(csv_name, CopyFormat::CSV)) << loader.GetError();
+
+  // a malformed line takes back the rows before it
+  {
+    std::ofstream out(csv_name);
+    out << "3,c,3\n4,d\n5,e,5\n";
+  }
+  ASSERT_EQ(DB_FAILED, loader.Load(csv_name, CopyFormat::CSV));
+  ASSERT_EQ(0, loader.GetError().find("line 2:")) << loader.GetError();
+  ASSERT_EQ(2, CountRows());
+  ASSERT_EQ(INVALID_PAGE_ID, Lookup(3).GetPageId());
+
+  // so does a key already in the table, or twice in the file
+  for (auto text : {"6,f,6\n1,a,1\n", "7,g,7\n7,g,7\n"}) {
+    {
+      std::ofstream out(csv_name);
+      out << text;
+    }
+    ASSERT_EQ(DB_FAILED, loader.Load(csv_name, CopyFormat::CSV));
+    ASSERT_EQ(2, CountRows());
+    ASSERT_EQ(INVALID_PAGE_ID, Lookup(6).GetPageId());
+    ASSERT_EQ(INVALID_PAGE_ID, Lookup(7).GetPageId());
+  }
+
+  // values that do not fit their column
+  for (auto text : {"8,h,x\n", "8,aaaaaaaaaaaaaaaaa,8\n", ",h,8\n", "99999999999,h,8\n"}) {
+    {
+      std::ofstream out(csv_name);
+      out << text;
+    }
+    ASSERT_EQ(DB_FAILED, loader.Load(csv_name, CopyFormat::CSV)) << text;
+  }
+  ASSERT_EQ(2, CountRows());
+  ASSERT_NE(INVALID_PAGE_ID, Lookup(1).GetPageId());
+
+  // a null in a nullable indexed column, the index could not order it among its keys
+  std::vector<Column *> code_columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                        new Column("code", TypeId::kTypeInt, 1, true, true)};
+  auto code_schema = std::make_shared<Schema>(code_columns);
+  TableInfo *code_table;
+  ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("v", code_schema.get(), nullptr, code_table));
+  IndexInfo *code_index;
+  std::vector<std::string> code_keys{"code"};
+  ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateIndex("v", "v_code", code_keys, nullptr, code_index, "bptree"));
+  {
+    std::ofstream out(csv_name);
+    out << "1,5\n2,\n3,\n";
+  }
+  CopyLoader code_loader(exec_ctx_.get(), code_table, {code_index}, 2);
+  ASSERT_EQ(DB_FAILED, code_loader.Load(csv_name, CopyFormat::CSV));
+  ASSERT_EQ("line 2: null key in index v_code", code_loader.GetError());
+  ASSERT_TRUE(code_table->GetTableHeap()->Begin(nullptr) == code_table->GetTableHeap()->End());
+}
+
+TEST_F(CopyLoaderTest, ParseTest) {
+  for (auto sql : {"copy t from \"data.csv\";", "copy t from \"data.bin\" binary;"}) {
+    MinisqlParserInit();
+    YY_BUFFER_STATE buffer = yy_scan_string(sql);
+    ASSERT_EQ(0, yyparse());
+    pSyntaxNode ast = MinisqlGetParserRootNode();
+    ASSERT_NE(nullptr, ast);
+    ASSERT_EQ(kNodeCopy, ast->type_);
+    ASSERT_EQ(kNodeIdentifier, ast->child_->type_);
+    ASSERT_STREQ("t", ast->child_->val_);
+    ASSERT_EQ(kNodeString, ast->child_->next_->type_);
+    pSyntaxNode format = ast->child_->next_->next_;
+    if (strstr(sql, "binary") != nullptr) {
+      ASSERT_STREQ("binary", format->val_);
+    } else {
+      ASSERT_EQ(nullptr, format);
+    }
+    MinisqlParserFinish();
+    yy_delete_buffer(buffer);
+  }
+}
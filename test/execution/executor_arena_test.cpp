@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/executors/delete_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/executors/update_executor.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "executor_arena_test.db";
+
+class ExecutorArenaTest : public ::testing::Test {
+ public:
+  static constexpr int kRowNums = 20000;
+
+  void SetUp() override {
+    remove(("./databases/" + db_name).c_str());
+    db_ = std::make_unique<DBStorageEngine>(db_name, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, true),
+                                     new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                     new Column("account", TypeId::kTypeFloat, 2, true, false)};
+    Schema schema(columns);
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info_));
+    std::vector<std::string> index_keys{"id"};
+    IndexInfo *index_info;
+    ASSERT_EQ(DB_SUCCESS, db_->catalog_mgr_->CreateIndex("t", "t_id", index_keys, nullptr, index_info, "bptree"));
+    char name[32];
+    for (int i = 0; i < kRowNums; i++) {
+      int len = snprintf(name, sizeof(name), "customer-%d", i);
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, len, true),
+                                Field(TypeId::kTypeFloat, i / 4.0f)};
+      Row row(fields);
+      ASSERT_TRUE(table_info_->GetTableHeap()->InsertTuple(row, nullptr));
+      Row key_row;
+      row.GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), key_row);
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(key_row, row.GetRowId(), nullptr));
+    }
+  }
+
+  void TearDown() override {
+    db_.reset();
+    remove(("./databases/" + db_name).c_str());
+  }
+
+  /** Run the executor to the end as ExecuteEngine::ExecutePlan does, collecting its rows. @return the row count */
+  static size_t Run(ExecuteContext *exec_ctx, AbstractExecutor *executor) {
+    std::vector<Row> result_set;
+    executor->Init();
+    Row row(exec_ctx->GetArena());
+    RowId rid;
+    while (executor->Next(&row, &rid)) {
+      result_set.push_back(std::move(row));
+    }
+    return result_set.size();
+  }
+
+  std::unique_ptr<DBStorageEngine> db_;
+  TableInfo *table_info_{nullptr};
+};
+
+TEST_F(ExecutorArenaTest, UpdateTest) {
+  auto exec_ctx = db_->MakeExecuteContext(nullptr);
+  SeqScanPlanNode scan_plan(table_info_->GetSchema(), "t");
+  std::unordered_map<uint32_t, AbstractExpressionRef> update_attrs{
+      {2, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeFloat, 1.5f))}};
+  UpdatePlanNode update_plan(table_info_->GetSchema(), nullptr, "t", update_attrs);
+  UpdateExecutor executor(exec_ctx.get(), &update_plan,
+                          std::make_unique<SeqScanExecutor>(exec_ctx.get(), &scan_plan));
+  ASSERT_EQ(kRowNums, Run(exec_ctx.get(), &executor));
+  // the rows of one update at a time, not of all of them
+  ASSERT_LE(exec_ctx->GetArena()->GetCapacity(), Arena::INLINE_BLOCK_SIZE + Arena::BLOCK_SIZE);
+
+  Field account(TypeId::kTypeFloat, 1.5f);
+  for (auto it = table_info_->GetTableHeap()->Begin(nullptr); it != table_info_->GetTableHeap()->End(); ++it) {
+    ASSERT_EQ(CmpBool::kTrue, it->GetField(2)->CompareEquals(account));
+  }
+}
+
+TEST_F(ExecutorArenaTest, DeleteTest) {
+  auto exec_ctx = db_->MakeExecuteContext(nullptr);
+  SeqScanPlanNode scan_plan(table_info_->GetSchema(), "t");
+  DeletePlanNode delete_plan(table_info_->GetSchema(), nullptr, "t");
+  DeleteExecutor executor(exec_ctx.get(), &delete_plan,
+                          std::make_unique<SeqScanExecutor>(exec_ctx.get(), &scan_plan));
+  ASSERT_EQ(kRowNums, Run(exec_ctx.get(), &executor));
+  ASSERT_LE(exec_ctx->GetArena()->GetCapacity(), Arena::INLINE_BLOCK_SIZE + Arena::BLOCK_SIZE);
+  ASSERT_TRUE(table_info_->GetTableHeap()->Begin(nullptr) == table_info_->GetTableHeap()->End());
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/executors/insert_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/executors/values_executor.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "row_arena_bench.db";
+
+// rows inserted and scanned, ROW_ARENA_BENCH_ROWS in the environment overrides it
+static const int kRowNums = 1000000;
+
+static std::atomic<uint64_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static int RowNums() {
+  const char *rows = getenv("ROW_ARENA_BENCH_ROWS");
+  return rows != nullptr ? atoi(rows) : kRowNums;
+}
+
+static void Report(const char *path, int rows, std::chrono::steady_clock::time_point start, uint64_t allocs_before) {
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t allocs = allocations.load() - allocs_before;
+  printf("%24s %10.2f %12.0f %12.2f\n", path, sec, rows / sec, static_cast<double>(allocs) / rows);
+}
+
+/**
+ * Insert rows through the insert and values executors and read them back with a sequential scan into a result set,
+ * once with the rows on the heap as the executors made them before, once with the rows in the arena of the execute
+ * context. Prints the rows per second and the allocations per row of each. Every execute context is one query, the
+ * values of one query are the constants of kQueryRows rows.
+ */
+TEST(RowArenaBench, InsertAndScan) {
+  const int kQueryRows = 100;
+  int rows = RowNums() / kQueryRows * kQueryRows;
+  auto db = std::make_unique<DBStorageEngine>(db_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  TableInfo *table_info;
+  ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info));
+  std::vector<std::vector<AbstractExpressionRef>> values;
+  char name[32];
+  for (int i = 0; i < kQueryRows; i++) {
+    int len = snprintf(name, sizeof(name), "customer-%d", i);
+    values.push_back({std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, i)),
+                      std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeChar, name, len, true)),
+                      std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeFloat, i / 4.0f))});
+  }
+  auto values_plan = std::make_shared<ValuesPlanNode>(table_info->GetSchema(), values);
+  InsertPlanNode insert_plan(table_info->GetSchema(), values_plan, "t");
+  SeqScanPlanNode scan_plan(table_info->GetSchema(), "t");
+  printf("%d rows, %d rows per query\n", rows, kQueryRows);
+  printf("%24s %10s %12s %12s\n", "path", "sec", "rows/sec", "allocs/row");
+
+  // as the insert and values executors did before: the values of a row evaluated into fields and copied into a row
+  // on the heap, which is inserted
+  auto start = std::chrono::steady_clock::now();
+  uint64_t allocs_before = allocations.load();
+  for (int q = 0; q < rows / kQueryRows; q++) {
+    auto exec_ctx = db->MakeExecuteContext(nullptr);
+    for (const auto &exprs : values_plan->GetValues()) {
+      std::vector<Field> fields;
+      for (const auto &expr : exprs) {
+        fields.emplace_back(expr->Evaluate(nullptr));
+      }
+      Row row;
+      row = Row{fields};
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+  }
+  Report("insert, heap rows", rows, start, allocs_before);
+
+  start = std::chrono::steady_clock::now();
+  allocs_before = allocations.load();
+  for (int q = 0; q < rows / kQueryRows; q++) {
+    auto exec_ctx = db->MakeExecuteContext(nullptr);
+    InsertExecutor executor(exec_ctx.get(), &insert_plan,
+                            std::make_unique<ValuesExecutor>(exec_ctx.get(), values_plan.get()));
+    executor.Init();
+    Row row(exec_ctx->GetArena());
+    RowId rid;
+    auto mark = exec_ctx->GetArena()->GetMark();
+    while (executor.Next(&row, &rid)) {
+      row.destroy();
+      exec_ctx->GetArena()->Rewind(mark);
+    }
+  }
+  Report("insert, arena rows", rows, start, allocs_before);
+
+  for (const char *path : {"scan, heap rows", "scan, arena rows"}) {
+    bool arena = path == std::string("scan, arena rows");
+    auto exec_ctx = db->MakeExecuteContext(nullptr);
+    std::vector<Row> result_set;
+    start = std::chrono::steady_clock::now();
+    allocs_before = allocations.load();
+    SeqScanExecutor executor(exec_ctx.get(), &scan_plan);
+    executor.Init();
+    Row row(arena ? exec_ctx->GetArena() : nullptr);
+    RowId rid;
+    while (executor.Next(&row, &rid)) {
+      if (arena) {
+        result_set.push_back(std::move(row));
+      } else {
+        result_set.push_back(row);
+      }
+    }
+    Report(path, 2 * rows, start, allocs_before);
+    ASSERT_EQ(2 * rows, result_set.size());
+  }
+  db.reset();
+  remove(("./databases/" + db_name).c_str());
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "seq_scan_bench.db";
+
+// rows scanned, SEQ_SCAN_BENCH_ROWS in the environment overrides it
+static const int kRowNums = 1000000;
+static const int kBatchRows = 10000;
+
+static std::atomic<uint64_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static int RowNums() {
+  const char *rows = getenv("SEQ_SCAN_BENCH_ROWS");
+  return rows != nullptr ? atoi(rows) : kRowNums;
+}
+
+/**
+ * Scan a table with a predicate on id that a given share of the rows pass, two ways: with a TableIterator that
+ * deserializes every tuple into a Row and evaluates the predicate on it, as SeqScanExecutor used to, and with
+ * SeqScanExecutor, which evaluates the predicate on a RowView of the tuple in its page and copies out only the rows
+ * that pass. Prints the rows scanned per second and the allocations per row scanned.
+ */
+TEST(SeqScanBench, Scan) {
+  int rows = RowNums();
+  auto db = std::make_unique<DBStorageEngine>(db_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  Schema schema(columns);
+  TableInfo *table_info;
+  ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->CreateTable("t", &schema, nullptr, table_info));
+  char name[32];
+  RowBatch batch;
+  for (int i = 0; i < rows; i++) {
+    int len = snprintf(name, sizeof(name), "customer-%d", i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, len, true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i % 10000) / 4)};
+    batch.AddRow(fields);
+    if (batch.Size() == kBatchRows || i == rows - 1) {
+      ASSERT_TRUE(table_info->GetTableHeap()->BulkInsert(batch, nullptr));
+      batch.Clear();
+    }
+  }
+  auto exec_ctx = db->MakeExecuteContext(nullptr);
+  printf("%d rows, %u pages\n", rows, table_info->GetTableHeap()->GetPageCount());
+  printf("%10s %16s %10s %12s %12s\n", "selected", "path", "sec", "rows/sec", "allocs/row");
+
+  for (int percent : {1, 10, 100}) {
+    int bound = static_cast<int>(static_cast<int64_t>(rows) * percent / 100);
+    auto predicate = std::make_shared<ComparisonExpression>(
+        std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt),
+        std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, bound)), "<");
+    SeqScanPlanNode plan(table_info->GetSchema(), "t", predicate);
+    for (const char *path : {"row iterator", "row view"}) {
+      int selected = 0;
+      uint64_t allocations_before = allocations.load();
+      auto start = std::chrono::steady_clock::now();
+      if (path == std::string("row iterator")) {
+        auto table_heap = table_info->GetTableHeap();
+        Row row;
+        for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+          if (!predicate->Evaluate(&*iter).CompareEquals(Field(kTypeInt, 1))) {
+            continue;
+          }
+          row = *iter;
+          selected++;
+        }
+      } else {
+        SeqScanExecutor executor(exec_ctx.get(), &plan);
+        executor.Init();
+        Row row;
+        RowId rid;
+        while (executor.Next(&row, &rid)) {
+          selected++;
+        }
+      }
+      double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      uint64_t allocs = allocations.load() - allocations_before;
+      ASSERT_EQ(bound, selected);
+      printf("%9d%% %16s %10.2f %12.0f %12.2f\n", percent, path, sec, rows / sec,
+             static_cast<double>(allocs) / rows);
+    }
+  }
+  exec_ctx.reset();
+  db.reset();
+  remove(("./databases/" + db_name).c_str());
+}
@@ -1,5 +1,7 @@
 #include "index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <random>
 #include <string>
 
 #include "common/instance.h"
@@ -82,4 +84,109 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   delete index;
   delete bpm_;
   delete disk_mgr_;
+}
+TEST(BPlusTreeTests, BPlusTreeIndexBulkLoadTest) {
+  std::string bulk_db_name = "bp_tree_index_bulk_test.db";
+  remove(bulk_db_name.c_str());
+  auto disk_mgr = new DiskManager(bulk_db_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  page_id_t id;
+  ASSERT_NE(nullptr, bpm->NewPage(id));
+  ASSERT_EQ(CATALOG_META_PAGE_ID, id);
+  ASSERT_NE(nullptr, bpm->NewPage(id));
+  ASSERT_EQ(INDEX_ROOTS_PAGE_ID, id);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, index_schema, 32, bpm);
+  const int num_keys = 20000;
+  std::vector<int> order(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(2024));
+  std::vector<Row> keys;
+  std::vector<RowId> row_ids;
+  for (int i : order) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * i)};
+    keys.emplace_back(fields);
+    row_ids.emplace_back(i, 0);
+  }
+
+  // Scenario: a duplicate key fails the load and builds nothing.
+  std::vector<Row> duplicate_keys{keys[0], keys[1], keys[0]};
+  ASSERT_EQ(DB_FAILED, index->InsertEntries(duplicate_keys, row_ids, nullptr));
+
+  // Scenario: so does a null key, it has no place in the key order.
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  std::vector<Row> null_keys{keys[0], Row(null_fields)};
+  ASSERT_EQ(DB_FAILED, index->InsertEntries(null_keys, row_ids, nullptr));
+
+  // Scenario: an empty tree is built from the entries, in key order.
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntries(keys, row_ids, nullptr));
+  int i = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter, i++) {
+    ASSERT_EQ(i, (*iter).second.GetPageId());
+  }
+  ASSERT_EQ(num_keys, i);
+  std::vector<RowId> ret;
+  for (int k = 0; k < num_keys; k += 97) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * k)};
+    Row key(fields);
+    ret.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, ret, nullptr));
+    ASSERT_EQ(k, ret[0].GetPageId());
+  }
+
+  // Scenario: the built tree takes inserts and removes like any other.
+  for (int k = 0; k < num_keys; k += 3) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * k + 1)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key, RowId(num_keys + k, 0), nullptr));
+  }
+  for (int k = 0; k < num_keys; k += 2) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * k)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, RowId(k, 0), nullptr));
+  }
+  int last = -1;
+  i = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter, i++) {
+    int key_value = (*iter).second.GetPageId() < num_keys ? 2 * (*iter).second.GetPageId()
+                                                          : 2 * ((*iter).second.GetPageId() - num_keys) + 1;
+    ASSERT_LT(last, key_value);
+    last = key_value;
+  }
+  ASSERT_EQ(num_keys / 2 + (num_keys + 2) / 3, i);
+
+  // Scenario: a tree with keys gets the entries inserted one by one.
+  std::vector<Row> more_keys;
+  std::vector<RowId> more_row_ids;
+  for (int k = 0; k < 100; k++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 4 * k)};
+    more_keys.emplace_back(fields);
+    more_row_ids.emplace_back(k, 0);
+  }
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntries(more_keys, more_row_ids, nullptr));
+  ASSERT_EQ(DB_FAILED, index->InsertEntries(more_keys, more_row_ids, nullptr));
+
+  // Scenario: a failed load into a tree with keys leaves none of its entries behind.
+  std::vector<Row> clashing_keys;
+  for (int k = 1; k <= 50; k++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, -k)};
+    clashing_keys.emplace_back(fields);
+  }
+  clashing_keys.push_back(more_keys[99]);
+  ASSERT_EQ(DB_FAILED, index->InsertEntries(clashing_keys, row_ids, nullptr));
+  for (auto &key : clashing_keys) {
+    ret.clear();
+    index->ScanKey(key, ret, nullptr);
+    ASSERT_EQ(&key == &clashing_keys.back() ? 1 : 0, ret.size());
+  }
+  index->Destroy();
+  delete index;
+  delete bpm;
+  delete disk_mgr;
+  remove(bulk_db_name.c_str());
 }
\ No newline at end of file
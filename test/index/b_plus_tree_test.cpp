@@ -3,6 +3,7 @@
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/comparator.h"
+#include "page/index_roots_page.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -324,4 +325,62 @@ TEST(BPlusTreeTests, GeneralSampleTest2) {
     tree.Remove(keys[i + offset]);
     ASSERT_FALSE(tree.GetValue(keys[i + offset], ans));
   }
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 17);
+  BPlusTree tree(0, engine.bpm_, KP);
+  const int n = 2000;
+  vector<std::pair<GenericKey *, RowId>> entries;
+  for (int i = 0; i < n; i++) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    entries.emplace_back(key, RowId(i));
+  }
+  ASSERT_TRUE(tree.BulkLoad(entries));
+  ASSERT_TRUE(tree.Check());
+
+  // walk the leaves from the leftmost one, @return the leaf count
+  auto count_leaves = [&](bool check_fill) {
+    auto *roots = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    page_id_t root_page_id;
+    EXPECT_TRUE(roots->GetRootId(0, &root_page_id));
+    engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    int leaves = 0;
+    Page *page = tree.FindLeafPage(nullptr, root_page_id, true);
+    while (true) {
+      auto *leaf = reinterpret_cast<BPlusTreeLeafPage *>(page->GetData());
+      if (check_fill) {
+        EXPECT_LE(leaf->GetSize(), leaf->GetMaxSize() * DEFAULT_BULK_LOAD_FILL_FACTOR);
+      }
+      leaves++;
+      page_id_t next_page_id = leaf->GetNextPageId();
+      engine.bpm_->UnpinPage(page->GetPageId(), false);
+      if (next_page_id == INVALID_PAGE_ID) {
+        break;
+      }
+      page = engine.bpm_->FetchPage(next_page_id);
+    }
+    return leaves;
+  };
+
+  // the leaves keep room, a few inserts into the loaded range split none of them
+  int leaves = count_leaves(true);
+  for (int i = 0; i < n; i += 40) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, 2 * i + 1)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    ASSERT_TRUE(tree.Insert(key, RowId(n + i)));
+  }
+  ASSERT_EQ(leaves, count_leaves(false));
+  ASSERT_TRUE(tree.Check());
+  vector<RowId> ans;
+  ASSERT_TRUE(tree.GetValue(entries[n / 2].first, ans));
+  ASSERT_EQ(RowId(n / 2), ans[0]);
 }
\ No newline at end of file
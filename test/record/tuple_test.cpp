@@ -3,8 +3,12 @@
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
 #include "record/field.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "record/schema.h"
 
 char *chars[] = {const_cast<char *>(""), const_cast<char *>("hello"), const_cast<char *>("world!"),
@@ -93,11 +97,64 @@ TEST(TupleTest, RowTest) {
   ASSERT_EQ(row.GetRowId(), first_tuple_rid);
   Row row2(row.GetRowId());
   ASSERT_TRUE(table_page.GetTuple(&row2, schema.get(), nullptr, nullptr));
-  std::vector<Field *> &row2_fields = row2.GetFields();
+  auto &row2_fields = row2.GetFields();
   ASSERT_EQ(3, row2_fields.size());
   for (size_t i = 0; i < row2_fields.size(); i++) {
     ASSERT_EQ(CmpBool::kTrue, row2_fields[i]->CompareEquals(fields[i]));
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
+}
+TEST(TupleTest, RowViewTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("note", TypeId::kTypeChar, 64, 2, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 3, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188), Field(TypeId::kTypeChar),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f)};
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+
+  RowView view;
+  view.Reset(buffer, schema.get(), RowId(1, 2));
+  ASSERT_EQ(RowId(1, 2), view.GetRowId());
+  ASSERT_EQ(4, view.GetFieldCount());
+  // fields are decoded in any order, a char field points into the buffer
+  ASSERT_EQ(CmpBool::kTrue, view.GetField(3).CompareEquals(fields[3]));
+  ASSERT_EQ(CmpBool::kTrue, view.GetField(0).CompareEquals(fields[0]));
+  ASSERT_TRUE(view.IsNull(1));
+  ASSERT_TRUE(view.GetField(1).IsNull());
+  Field note = view.GetField(2);
+  ASSERT_EQ(CmpBool::kTrue, note.CompareEquals(fields[2]));
+  ASSERT_GE(note.GetData(), buffer);
+  ASSERT_LT(note.GetData(), buffer + sizeof(buffer));
+
+  // a predicate is evaluated on the view
+  auto name_is_minisql = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 2, TypeId::kTypeChar),
+      std::make_shared<ConstantValueExpression>(fields[2]), "=");
+  ASSERT_EQ(CmpBool::kTrue, name_is_minisql->Evaluate(view).CompareEquals(Field(TypeId::kTypeInt, 1)));
+  auto id_is_small = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt),
+      std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 100)), "<");
+  ASSERT_EQ(CmpBool::kFalse, id_is_small->Evaluate(view).CompareEquals(Field(TypeId::kTypeInt, 1)));
+
+  // rows copied out own their fields and outlive the bytes
+  Row all;
+  Row projected;
+  view.ToRow(all);
+  view.ToRow({3, 2}, projected);
+  memset(buffer, 0, sizeof(buffer));
+  ASSERT_EQ(RowId(1, 2), all.GetRowId());
+  ASSERT_EQ(4, all.GetFieldCount());
+  for (size_t i = 0; i < fields.size(); i++) {
+    ASSERT_EQ(fields[i].IsNull(), all.GetField(i)->IsNull());
+    ASSERT_NE(CmpBool::kFalse, all.GetField(i)->CompareEquals(fields[i]));
+  }
+  ASSERT_EQ(2, projected.GetFieldCount());
+  ASSERT_EQ(CmpBool::kTrue, projected.GetField(0)->CompareEquals(fields[3]));
+  ASSERT_EQ(CmpBool::kTrue, projected.GetField(1)->CompareEquals(fields[2]));
 }
\ No newline at end of file
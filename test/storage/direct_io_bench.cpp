@@ -0,0 +1,88 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+static const std::string db_name = "direct_io_bench.db";
+
+static const size_t kPoolSize = 1024;
+static const int kPageNums = 16384;
+static const int kFetchNums = 50000;
+
+/** @return the pages of a file held in the kernel page cache */
+static size_t CachedPages(const std::string &file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  off_t size = lseek(fd, 0, SEEK_END);
+  size_t os_pages = (size + sysconf(_SC_PAGESIZE) - 1) / sysconf(_SC_PAGESIZE);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  std::vector<unsigned char> resident(os_pages);
+  mincore(mapping, size, resident.data());
+  size_t cached = 0;
+  for (auto r : resident) {
+    cached += r & 1;
+  }
+  munmap(mapping, size);
+  close(fd);
+  return cached * sysconf(_SC_PAGESIZE) / PAGE_SIZE;
+}
+
+/**
+ * Random page fetches through a buffer pool sixteen times smaller than the working set, once with buffered I/O and once
+ * with O_DIRECT. Buffered misses are often served by the kernel page cache, which keeps a second copy of the file;
+ * direct misses always go to the device but cost no memory outside the pool. Prints the fetch rate and the pages of
+ * the file left in the page cache.
+ */
+TEST(DirectIOBench, RandomFetch) {
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE]{};
+  for (int i = 0; i < kPageNums; i++) {
+    disk_mgr->AllocatePage();
+    memset(data, 'a' + i % 26, PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+    disk_mgr->WritePage(i, data);
+  }
+  delete disk_mgr;
+
+  printf("%d pages, %zu frames, %d fetches\n", kPageNums, kPoolSize, kFetchNums);
+  printf("%10s %10s %10s %12s %14s\n", "mode", "reads", "ms", "fetches/sec", "cached pages");
+  for (bool direct_io : {false, true}) {
+    // start both runs with a cold page cache
+    int fd = open(db_name.c_str(), O_RDONLY);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    disk_mgr = new DiskManager(db_name);
+    if (disk_mgr->SetDirectIO(direct_io) != direct_io) {
+      printf("%10s not supported by the filesystem\n", "direct");
+      delete disk_mgr;
+      break;
+    }
+    auto *bpm = new BufferPoolManager(kPoolSize, disk_mgr);
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<page_id_t> dist(0, kPageNums - 1);
+    DiskIOStats before = disk_mgr->GetIOStats();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kFetchNums; i++) {
+      page_id_t page_id = dist(rng);
+      Page *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page);
+      ASSERT_EQ('a' + page_id % 26, page->GetData()[0]);
+      bpm->UnpinPage(page_id, false);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    uint64_t reads = disk_mgr->GetIOStats().reads_ - before.reads_;
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    printf("%10s %10lu %10.1f %12.0f %14zu\n", direct_io ? "direct" : "buffered", reads, ms, kFetchNums * 1000.0 / ms,
+           CachedPages(db_name));
+    delete bpm;
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "disk_allocation_bench.db";
+
+static const size_t kPoolSize = 16384;
+static const int kRowNums = 50000;
+
+/**
+ * Bulk insert into a table heap with a pool large enough to hold the table, so the only disk I/O during the load is
+ * page allocation. Page allocation used to read and write the extent bitmap and rewrite the meta page every time, the
+ * bitmaps are in memory now and written once at the checkpoint.
+ */
+TEST(DiskAllocationBench, BulkInsert) {
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(kPoolSize, disk_mgr);
+  // only the checkpoint writes pages back
+  bpm->SetDirtyRatioThreshold(1.0);
+  std::vector<Column *> columns{new Column("id", TypeId::kTypeInt, 0, false, false),
+                                new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  TableSchema table_schema(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, &table_schema, nullptr, nullptr, nullptr);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+
+  DiskIOStats before = disk_mgr->GetIOStats();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRowNums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i))};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  auto loaded = std::chrono::steady_clock::now();
+  DiskIOStats load = disk_mgr->GetIOStats();
+  bpm->FlushAllPages();
+  auto stop = std::chrono::steady_clock::now();
+  DiskIOStats checkpoint = disk_mgr->GetIOStats();
+
+  auto pages = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages();
+  printf("%d rows, %u pages allocated\n", kRowNums, pages);
+  printf("%12s %10s %10s %10s\n", "phase", "reads", "writes", "ms");
+  printf("%12s %10lu %10lu %10.1f\n", "load", load.reads_ - before.reads_, load.writes_ - before.writes_,
+         std::chrono::duration<double, std::milli>(loaded - start).count());
+  printf("%12s %10lu %10lu %10.1f\n", "checkpoint", checkpoint.reads_ - load.reads_, checkpoint.writes_ - load.writes_,
+         std::chrono::duration<double, std::milli>(stop - loaded).count());
+  printf("bitmap and meta page I/O per allocation: %.3f (was 3: bitmap read, bitmap write, meta page write)\n",
+         static_cast<double>(checkpoint.reads_ - before.reads_ + checkpoint.writes_ - before.writes_ - pages) / pages);
+  // nothing but the data pages, one bitmap and the meta page is written
+  EXPECT_EQ(0, load.writes_ - before.writes_);
+  EXPECT_EQ(pages + 2, checkpoint.writes_ - before.writes_);
+
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
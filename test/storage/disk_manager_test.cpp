@@ -1,9 +1,27 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
+#include "common/crc32c.h"
 #include "gtest/gtest.h"
 
+/** A page of c, the bytes of the page checksum are left zero as every page layout does. */
+static std::string FilledPage(char c) {
+  std::string page(PAGE_SIZE, '\0');
+  memset(&page[0], c, PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+  return page;
+}
+
 TEST(DiskManagerTest, BitMapPageTest) {
   const size_t size = 512;
   char buf[size];
@@ -34,6 +52,29 @@ TEST(DiskManagerTest, BitMapPageTest) {
   ASSERT_FALSE(bitmap->AllocatePage(ofs));
 }
 
+TEST(DiskManagerTest, BitMapPageWordScanTest) {
+  BitmapPage<PAGE_SIZE> bitmap;
+  const uint32_t num_pages = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+  uint32_t ofs;
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_TRUE(bitmap.AllocatePage(ofs));
+    ASSERT_EQ(i, ofs);
+  }
+  ASSERT_FALSE(bitmap.AllocatePage(ofs));
+
+  // Scenario: pages freed at and across word boundaries are handed out again lowest first.
+  std::vector<uint32_t> freed{num_pages - 1, 4000, 64, 63, 0};
+  for (auto page : freed) {
+    ASSERT_TRUE(bitmap.DeAllocatePage(page));
+  }
+  std::sort(freed.begin(), freed.end());
+  for (auto page : freed) {
+    ASSERT_TRUE(bitmap.AllocatePage(ofs));
+    EXPECT_EQ(page, ofs);
+  }
+  ASSERT_FALSE(bitmap.AllocatePage(ofs));
+}
+
 TEST(DiskManagerTest, FreePageAllocationTest) {
   std::string db_name = "disk_test.db";
   remove(db_name.c_str());
@@ -56,4 +97,450 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(extent_nums * DiskManager::BITMAP_SIZE - 5, meta_page->GetAllocatedPages());
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
-}
\ No newline at end of file
+
+  // Scenario: freed pages are reused before a new extent is started, from the first extent with free pages.
+  EXPECT_EQ(0, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE - 1, disk_mgr->AllocatePage());
+  EXPECT_EQ(DiskManager::BITMAP_SIZE, disk_mgr->AllocatePage());
+  EXPECT_EQ(extent_nums, meta_page->GetExtentNums());
+}
+TEST(DiskManagerTest, MetadataFlushTest) {
+  std::string db_name = "disk_meta_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint32_t num_pages = DiskManager::BITMAP_SIZE + 10;
+
+  // Scenario: allocating and freeing pages does no disk I/O.
+  DiskIOStats before = disk_mgr->GetIOStats();
+  for (uint32_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  disk_mgr->DeAllocatePage(3);
+  disk_mgr->DeAllocatePage(DiskManager::BITMAP_SIZE + 3);
+  EXPECT_TRUE(disk_mgr->IsPageFree(3));
+  EXPECT_FALSE(disk_mgr->IsPageFree(4));
+  EXPECT_TRUE(disk_mgr->IsPageFree(num_pages));
+  DiskIOStats after = disk_mgr->GetIOStats();
+  EXPECT_EQ(before.reads_, after.reads_);
+  EXPECT_EQ(before.writes_, after.writes_);
+
+  // Scenario: a flush and sync writes the two changed bitmaps and the meta page once, a second flush writes nothing.
+  disk_mgr->FlushMetadata();
+  disk_mgr->Sync();
+  EXPECT_EQ(after.writes_ + 3, disk_mgr->GetIOStats().writes_);
+  disk_mgr->FlushMetadata();
+  disk_mgr->Sync();
+  EXPECT_EQ(after.writes_ + 3, disk_mgr->GetIOStats().writes_);
+  EXPECT_TRUE(disk_mgr->IsPageFree(3));
+  disk_mgr->AllocatePage();
+  delete disk_mgr;
+
+  // Scenario: the bitmaps are read back on open, changes made after the last flush are written by Close.
+  disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(num_pages - 1, meta_page->GetAllocatedPages());
+  EXPECT_EQ(2, meta_page->GetExtentNums());
+  EXPECT_FALSE(disk_mgr->IsPageFree(3));
+  EXPECT_TRUE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 3));
+  EXPECT_FALSE(disk_mgr->IsPageFree(DiskManager::BITMAP_SIZE + 4));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, WriteBatchingTest) {
+  std::string db_name = "disk_write_batch_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(DiskWriteMode::BATCHED, disk_mgr->GetWriteMode());
+  char data[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+
+  // Scenario: a queued write is read back before it reaches the disk, the last write of a page wins.
+  DiskIOStats before = disk_mgr->GetIOStats();
+  memcpy(data, FilledPage('a').data(), PAGE_SIZE);
+  disk_mgr->WritePage(0, data);
+  memcpy(data, FilledPage('b').data(), PAGE_SIZE);
+  disk_mgr->WritePage(0, data);
+  disk_mgr->ReadPage(0, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  EXPECT_EQ(before.writes_, disk_mgr->GetIOStats().writes_);
+
+  // Scenario: Sync writes the page once.
+  disk_mgr->Sync();
+  EXPECT_EQ(before.writes_ + 1, disk_mgr->GetIOStats().writes_);
+  memset(buf, 0, PAGE_SIZE);
+  disk_mgr->ReadPage(0, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+
+  // Scenario: a full batch is written out without a Sync.
+  for (int i = 0; i < DISK_WRITE_BATCH_PAGES; i++) {
+    disk_mgr->WritePage(i, data);
+  }
+  EXPECT_EQ(before.writes_ + 1 + DISK_WRITE_BATCH_PAGES, disk_mgr->GetIOStats().writes_);
+
+  // Scenario: in write-through mode every write goes to disk at once.
+  disk_mgr->SetWriteMode(DiskWriteMode::WRITE_THROUGH);
+  DiskIOStats through = disk_mgr->GetIOStats();
+  memcpy(data, FilledPage('c').data(), PAGE_SIZE);
+  disk_mgr->WritePage(1, data);
+  EXPECT_EQ(through.writes_ + 1, disk_mgr->GetIOStats().writes_);
+  delete disk_mgr;
+
+  // Scenario: the writes survive reopening.
+  disk_mgr = new DiskManager(db_name);
+  disk_mgr->ReadPage(1, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PreallocationTest) {
+  std::string db_name = "disk_preallocation_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const uint64_t extent_bytes = (1 + DiskManager::BITMAP_SIZE) * PAGE_SIZE;
+  const uint64_t chunk_bytes = DEFAULT_DISK_PREALLOCATE_PAGES * PAGE_SIZE;
+  struct stat stat_buf;
+
+  // Scenario: the first allocation reserves a chunk without growing the file, not the whole extent.
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  EXPECT_GE(static_cast<uint64_t>(stat_buf.st_blocks) * 512, chunk_bytes);
+  EXPECT_LT(static_cast<uint64_t>(stat_buf.st_blocks) * 512, extent_bytes / 2);
+  EXPECT_LT(static_cast<uint64_t>(stat_buf.st_size), chunk_bytes);
+
+  // Scenario: a page past the chunk reserves the next one, twice as large.
+  for (int i = 1; i <= DEFAULT_DISK_PREALLOCATE_PAGES; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  ASSERT_EQ(0, stat(db_name.c_str(), &stat_buf));
+  EXPECT_GE(static_cast<uint64_t>(stat_buf.st_blocks) * 512, 3 * chunk_bytes);
+  EXPECT_LT(static_cast<uint64_t>(stat_buf.st_blocks) * 512, extent_bytes / 2);
+
+  // Scenario: a preallocated page that was never written reads as zeros without disk I/O.
+  char data[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+  memcpy(data, FilledPage('a').data(), PAGE_SIZE);
+  memset(buf, 'a', PAGE_SIZE);
+  disk_mgr->WritePage(0, data);
+  disk_mgr->Sync();
+  DiskIOStats before = disk_mgr->GetIOStats();
+  disk_mgr->ReadPage(DiskManager::BITMAP_SIZE - 1, buf);
+  EXPECT_EQ(before.reads_, disk_mgr->GetIOStats().reads_);
+  memset(data, 0, PAGE_SIZE);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ReadOnlyMappingTest) {
+  std::string db_name = "disk_read_only_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+  memcpy(data, FilledPage('a').data(), PAGE_SIZE);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  disk_mgr->WritePage(0, data);
+  delete disk_mgr;
+
+  // Scenario: pages are copied out of the mapping, no read is issued.
+  disk_mgr = new DiskManager(db_name, DiskIOBackendType::IO_URING, true);
+  ASSERT_TRUE(disk_mgr->IsReadOnly());
+  EXPECT_FALSE(disk_mgr->IsPageFree(0));
+  disk_mgr->ReadPage(0, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  disk_mgr->ReadPage(1, buf);
+  memset(data, 0, PAGE_SIZE);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  EXPECT_EQ(0, disk_mgr->GetIOStats().reads_);
+
+  // Scenario: writes and allocations are rejected.
+  disk_mgr->WritePage(0, data);
+  EXPECT_EQ(INVALID_PAGE_ID, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(0);
+  EXPECT_FALSE(disk_mgr->IsPageFree(0));
+  disk_mgr->ReadPage(0, buf);
+  EXPECT_EQ('a', buf[0]);
+  EXPECT_EQ(0, disk_mgr->GetIOStats().writes_);
+  delete disk_mgr;
+
+  // Scenario: a missing db file is not created.
+  remove(db_name.c_str());
+  EXPECT_ANY_THROW(new DiskManager(db_name, DiskIOBackendType::IO_URING, true));
+}
+
+TEST(DiskManagerTest, FormatVersionTest) {
+  std::string db_name = "disk_format_version_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(DiskFileMetaPage::MAGIC, meta_page->magic_);
+  EXPECT_EQ(DiskFileMetaPage::FORMAT_VERSION, meta_page->version_);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  delete disk_mgr;
+
+  // Scenario: the version is written to the file and read back.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(1, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+  // the double-write area keeps no copy of the meta page to repair it from
+  disk_mgr->WritePage(0, FilledPage('x').data());
+  delete disk_mgr;
+
+  // Scenario: a file of another version is refused, a version 1 file has no magic.
+  int fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  uint32_t version = DiskFileMetaPage::FORMAT_VERSION + 1;
+  ASSERT_EQ(sizeof(version), pwrite(fd, &version, sizeof(version), offsetof(DiskFileMetaPage, version_)));
+  EXPECT_ANY_THROW(new DiskManager(db_name));
+  uint32_t old_meta[2] = {1, 1};
+  ASSERT_EQ(sizeof(old_meta), pwrite(fd, old_meta, sizeof(old_meta), 0));
+  close(fd);
+  EXPECT_ANY_THROW(new DiskManager(db_name));
+  EXPECT_ANY_THROW(new DiskManager(db_name, DiskIOBackendType::IO_URING, true));
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ChecksumTest) {
+  // Scenario: the CRC32C check value, the same with and without SSE4.2.
+  const char check[] = "123456789";
+  EXPECT_EQ(0xe3069283, Crc32c(check, 9));
+  EXPECT_EQ(0xe3069283, Crc32cSoftware(check, 9));
+  std::string page = FilledPage('x');
+  page[17] = 'y';
+  EXPECT_EQ(Crc32cSoftware(page.data(), 1001), Crc32c(page.data(), 1001));
+  EXPECT_EQ(Crc32c(page.data() + 100, 901, Crc32c(page.data(), 100)), Crc32c(page.data(), 1001));
+
+  std::string db_name = "disk_checksum_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  ASSERT_EQ(1, disk_mgr->AllocatePage());
+  disk_mgr->WritePage(1, page.data());
+  disk_mgr->Sync();
+  // page 1 is not in the last batch, the double-write area has no copy of it
+  disk_mgr->WritePage(0, page.data());
+  delete disk_mgr;
+
+  // Scenario: flip a byte of logical page 1 behind the disk manager's back.
+  int fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  char byte = 'z';
+  ASSERT_EQ(1, pwrite(fd, &byte, 1, (DiskManager::FIRST_EXTENT_PAGE_ID + 2) * PAGE_SIZE + 1234));
+  close(fd);
+
+  // Scenario: the intact page reads fine, the corrupted one is detected.
+  disk_mgr = new DiskManager(db_name);
+  char buf[PAGE_SIZE];
+  EXPECT_TRUE(disk_mgr->ReadPage(0, buf));
+  EXPECT_EQ(page, std::string(buf, PAGE_SIZE));
+  EXPECT_EQ(0, disk_mgr->GetIOStats().checksum_failures_);
+  EXPECT_FALSE(disk_mgr->ReadPage(1, buf));
+  std::promise<bool> read_ok;
+  disk_mgr->SubmitRead(1, buf, [&read_ok](bool ok) { read_ok.set_value(ok); });
+  EXPECT_FALSE(read_ok.get_future().get());
+  EXPECT_EQ(2, disk_mgr->GetIOStats().checksum_failures_);
+  EXPECT_EQ(0, disk_mgr->GetRepairedPages());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, TornPageRepairTest) {
+  std::string db_name = "disk_torn_page_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  ASSERT_EQ(1, disk_mgr->AllocatePage());
+  // the metadata goes out first, so that the last batch holds the two pages
+  disk_mgr->FlushMetadata();
+  disk_mgr->Sync();
+  std::string page = FilledPage('x');
+  disk_mgr->WritePage(0, page.data());
+  disk_mgr->WritePage(1, page.data());
+  DiskIOStats before = disk_mgr->GetIOStats();
+  disk_mgr->Sync();
+
+  // Scenario: the batch goes to the double-write area with one write, then in place.
+  EXPECT_EQ(before.double_writes_ + 1, disk_mgr->GetIOStats().double_writes_);
+  EXPECT_EQ(before.writes_ + 2, disk_mgr->GetIOStats().writes_);
+  delete disk_mgr;
+
+  // Scenario: a crash tore the second half of page 1 while it was written in place.
+  const uint64_t offset = (DiskManager::FIRST_EXTENT_PAGE_ID + 2) * PAGE_SIZE;
+  int fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  std::string torn(PAGE_SIZE / 2, 'o');
+  ASSERT_EQ(PAGE_SIZE / 2, pwrite(fd, torn.data(), torn.size(), offset + PAGE_SIZE / 2));
+  close(fd);
+
+  // Scenario: opening the file puts the copy from the double-write area back.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(1, disk_mgr->GetRepairedPages());
+  char buf[PAGE_SIZE];
+  disk_mgr->ReadPage(1, buf);
+  EXPECT_EQ(page, std::string(buf, PAGE_SIZE));
+  EXPECT_EQ(0, disk_mgr->GetIOStats().checksum_failures_);
+  delete disk_mgr;
+
+  // Scenario: a torn double-write area is ignored, the pages in place were not written yet.
+  fd = open(db_name.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(PAGE_SIZE / 2, pwrite(fd, torn.data(), torn.size(), DiskManager::DOUBLE_WRITE_PAGE_ID * PAGE_SIZE));
+  close(fd);
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(0, disk_mgr->GetRepairedPages());
+  disk_mgr->ReadPage(1, buf);
+  EXPECT_EQ(page, std::string(buf, PAGE_SIZE));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, ConcurrentPageIOTest) {
+  std::string db_name = "disk_io_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < num_threads * pages_per_thread; i++) {
+    page_ids.push_back(disk_mgr->AllocatePage());
+  }
+
+  // Scenario: a page that was never written reads as zeros.
+  char data[PAGE_SIZE];
+  memset(data, 'x', PAGE_SIZE);
+  disk_mgr->ReadPage(page_ids.back(), data);
+  EXPECT_EQ(std::string(PAGE_SIZE, '\0'), std::string(data, PAGE_SIZE));
+
+  // Scenario: threads write and read back disjoint pages at the same time.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      char buf[PAGE_SIZE];
+      for (int round = 0; round < 4; round++) {
+        for (int i = t; i < num_threads * pages_per_thread; i += num_threads) {
+          memcpy(buf, FilledPage('a' + (i + round) % 26).data(), PAGE_SIZE);
+          disk_mgr->WritePage(page_ids[i], buf);
+          disk_mgr->ReadPage(page_ids[i], buf);
+          EXPECT_EQ(FilledPage('a' + (i + round) % 26), std::string(buf, PAGE_SIZE));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: the pages and the allocation metadata survive a reopen.
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(num_threads * pages_per_thread,
+            reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+  for (int i = 0; i < num_threads * pages_per_thread; i++) {
+    disk_mgr->ReadPage(page_ids[i], data);
+    EXPECT_EQ(FilledPage('a' + (i + 3) % 26), std::string(data, PAGE_SIZE));
+  }
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, AsyncPageIOTest) {
+  for (auto backend_type : {DiskIOBackendType::IO_URING, DiskIOBackendType::THREAD_POOL}) {
+    std::string db_name = "disk_async_io_test.db";
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, backend_type);
+    if (backend_type == DiskIOBackendType::THREAD_POOL) {
+      EXPECT_EQ(DiskIOBackendType::THREAD_POOL, disk_mgr->GetIOBackendType());
+    }
+    const int num_pages = 256;
+    std::vector<page_id_t> page_ids;
+    for (int i = 0; i < num_pages; i++) {
+      page_ids.push_back(disk_mgr->AllocatePage());
+    }
+
+    // Scenario: many writes are in flight at once, every one completes.
+    std::vector<std::string> pages;
+    for (int i = 0; i < num_pages; i++) {
+      pages.push_back(FilledPage('a' + i % 26));
+    }
+    std::atomic<int> written{0};
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->SubmitWrite(page_ids[i], pages[i].data(), [&written](bool ok) {
+        EXPECT_TRUE(ok);
+        written++;
+      });
+    }
+    while (written < num_pages) {
+      std::this_thread::yield();
+    }
+
+    // Scenario: reads submitted together see the pages, and the synchronous read agrees.
+    std::vector<std::string> buffers(num_pages, std::string(PAGE_SIZE, '\0'));
+    std::atomic<int> read{0};
+    for (int i = 0; i < num_pages; i++) {
+      disk_mgr->SubmitRead(page_ids[i], &buffers[i][0], [&read](bool ok) {
+        EXPECT_TRUE(ok);
+        read++;
+      });
+    }
+    while (read < num_pages) {
+      std::this_thread::yield();
+    }
+    char data[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(pages[i], buffers[i]);
+      disk_mgr->ReadPage(page_ids[i], data);
+      EXPECT_EQ(pages[i], std::string(data, PAGE_SIZE));
+    }
+    delete disk_mgr;
+    remove(db_name.c_str());
+  }
+}
+
+TEST(DiskManagerTest, DirectIOTest) {
+  std::string db_name = "disk_direct_io_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  ASSERT_FALSE(disk_mgr->IsDirectIO());
+  // the filesystem may not support O_DIRECT, page I/O works either way
+  bool direct_io = disk_mgr->SetDirectIO(true);
+  EXPECT_EQ(direct_io, disk_mgr->IsDirectIO());
+  alignas(PAGE_SIZE) char aligned[PAGE_SIZE];
+  // one byte off the page boundary, reads into it go through a bounce page
+  alignas(PAGE_SIZE) char unaligned_buf[PAGE_SIZE + 1];
+  char *unaligned = unaligned_buf + 1;
+  const int num_pages = 2 * DISK_WRITE_BATCH_PAGES;
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    disk_mgr->WritePage(i, FilledPage('a' + i % 26).data());
+  }
+  disk_mgr->Sync();
+
+  // Scenario: pages read back into aligned and unaligned buffers alike.
+  for (int i = 0; i < num_pages; i++) {
+    disk_mgr->ReadPage(i, i % 2 == 0 ? aligned : unaligned);
+    ASSERT_EQ(0, memcmp(FilledPage('a' + i % 26).data(), i % 2 == 0 ? aligned : unaligned, PAGE_SIZE));
+  }
+  // Scenario: a page beyond the end of the file still reads as zeros.
+  memset(unaligned, 'x', PAGE_SIZE);
+  disk_mgr->ReadPage(num_pages, unaligned);
+  EXPECT_EQ(0, memcmp(FilledPage('\0').data(), unaligned, PAGE_SIZE));
+  EXPECT_EQ(0, disk_mgr->GetIOStats().checksum_failures_);
+
+  // Scenario: turning direct I/O off again keeps the pages.
+  EXPECT_FALSE(disk_mgr->SetDirectIO(false));
+  EXPECT_FALSE(disk_mgr->IsDirectIO());
+  disk_mgr->ReadPage(1, aligned);
+  EXPECT_EQ(0, memcmp(FilledPage('b').data(), aligned, PAGE_SIZE));
+  delete disk_mgr;
+
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(direct_io, disk_mgr->SetDirectIO(true));
+  for (int i = 0; i < num_pages; i++) {
+    disk_mgr->ReadPage(i, unaligned);
+    ASSERT_EQ(0, memcmp(FilledPage('a' + i % 26).data(), unaligned, PAGE_SIZE));
+  }
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
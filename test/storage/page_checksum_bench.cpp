@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/crc32c.h"
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+static const int kPageNums = 4096;
+static const int kRounds = 16;
+
+/**
+ * Cost of checksumming a page on its way to and from disk, with the SSE4.2 instruction (if the CPU has it) and with
+ * the lookup table.
+ */
+TEST(PageChecksumBench, PerPageCost) {
+  std::mt19937 rng(2024);
+  std::vector<char> pages(static_cast<size_t>(kPageNums) * PAGE_SIZE);
+  for (auto &c : pages) {
+    c = static_cast<char>(rng());
+  }
+  printf("hardware crc32c: %s\n", Crc32cIsHardware() ? "yes" : "no");
+  printf("%10s %12s %10s\n", "path", "ns/page", "GB/s");
+  uint32_t sink = 0;
+  for (bool hardware : {true, false}) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; round++) {
+      for (int i = 0; i < kPageNums; i++) {
+        const char *page = pages.data() + static_cast<size_t>(i) * PAGE_SIZE;
+        sink += hardware ? Crc32c(page, PAGE_SIZE - PAGE_CHECKSUM_SIZE)
+                         : Crc32cSoftware(page, PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+      }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count() / (kPageNums * kRounds);
+    printf("%10s %12.1f %10.2f\n", hardware ? "crc32c" : "table", ns, PAGE_SIZE / ns);
+  }
+  EXPECT_EQ(Crc32c(pages.data(), pages.size()), Crc32cSoftware(pages.data(), pages.size()));
+  printf("(%u)\n", sink);
+}
+
+/** Page reads through the disk manager, the checksum is verified on each. */
+TEST(PageChecksumBench, ReadPage) {
+  std::string db_name = "page_checksum_bench.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE]{};
+  for (int i = 0; i < kPageNums; i++) {
+    disk_mgr->AllocatePage();
+    memset(data, 'a' + i % 26, PAGE_SIZE - PAGE_CHECKSUM_SIZE);
+    disk_mgr->WritePage(i, data);
+  }
+  disk_mgr->Sync();
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < kRounds; round++) {
+    for (int i = 0; i < kPageNums; i++) {
+      disk_mgr->ReadPage(i, data);
+    }
+  }
+  auto stop = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count() / (kPageNums * kRounds);
+  printf("ReadPage from the page cache: %.1f ns/page, checksum failures: %lu\n", ns,
+         disk_mgr->GetIOStats().checksum_failures_);
+  EXPECT_EQ(0, disk_mgr->GetIOStats().checksum_failures_);
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "table_heap_insert_bench.db";
+
+static const int kRowNums = 1000000;
+static const int kReportRows = 100000;
+static const int kBatchRows = 10000;
+
+/**
+ * Bulk insert into a table heap. With the free-space map every insert goes straight to a page with room, so the cost
+ * per row stays flat as the heap grows. Prints the insert rate and the page fetches per row of each slice of rows.
+ */
+TEST(TableHeapInsertBench, InsertTuple) {
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns{new Column("id", TypeId::kTypeInt, 0, false, false),
+                                new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  TableSchema table_schema(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, &table_schema, nullptr, nullptr, nullptr);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  printf("%10s %10s %12s %14s\n", "rows", "pages", "rows/sec", "fetches/row");
+  auto start = std::chrono::steady_clock::now();
+  BufferPoolStats before = bpm->GetStats();
+  for (int i = 0; i < kRowNums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                              Field(TypeId::kTypeFloat, static_cast<float>(i))};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    if ((i + 1) % kReportRows == 0) {
+      auto stop = std::chrono::steady_clock::now();
+      BufferPoolStats after = bpm->GetStats();
+      double sec = std::chrono::duration<double>(stop - start).count();
+      uint64_t fetches = after.hits_ + after.misses_ - before.hits_ - before.misses_;
+      printf("%10d %10u %12.0f %14.2f\n", i + 1, table_heap->GetPageCount(), kReportRows / sec,
+             static_cast<double>(fetches) / kReportRows);
+      start = stop;
+      before = after;
+    }
+  }
+
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+/**
+ * Load the same rows one at a time and through BulkInsert in batches of kBatchRows. Prints the rows per second and
+ * the page fetches per row of each.
+ */
+TEST(TableHeapInsertBench, BulkInsert) {
+  printf("%d rows, batches of %d\n", kRowNums, kBatchRows);
+  printf("%12s %10s %12s %14s\n", "path", "ms", "rows/sec", "fetches/row");
+  for (bool bulk : {false, true}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+    std::vector<Column *> columns{new Column("id", TypeId::kTypeInt, 0, false, false),
+                                  new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                  new Column("account", TypeId::kTypeFloat, 2, true, false)};
+    TableSchema table_schema(columns);
+    TableHeap *table_heap = TableHeap::Create(bpm, &table_schema, nullptr, nullptr, nullptr);
+    char name[64];
+    memset(name, 'x', sizeof(name));
+    RowBatch batch;
+    BufferPoolStats before = bpm->GetStats();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRowNums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                                Field(TypeId::kTypeFloat, static_cast<float>(i))};
+      if (!bulk) {
+        Row row(fields);
+        ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+        continue;
+      }
+      batch.AddRow(fields);
+      if (batch.Size() == kBatchRows) {
+        ASSERT_TRUE(table_heap->BulkInsert(batch, nullptr));
+        batch.Clear();
+      }
+    }
+    ASSERT_TRUE(table_heap->BulkInsert(batch, nullptr));
+    auto stop = std::chrono::steady_clock::now();
+    BufferPoolStats after = bpm->GetStats();
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    uint64_t fetches = after.hits_ + after.misses_ - before.hits_ - before.misses_;
+    printf("%12s %10.1f %12.0f %14.3f\n", bulk ? "BulkInsert" : "InsertTuple", ms, kRowNums * 1000.0 / ms,
+           static_cast<double>(fetches) / kRowNums);
+    delete table_heap;
+    delete bpm;
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
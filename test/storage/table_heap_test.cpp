@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "record/field.h"
 #include "record/schema.h"
+#include "storage/table_scanner.h"
 #include "utils/utils.h"
 
 static string db_file_name = "table_heap_test.db";
@@ -61,3 +62,175 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  auto make_row = [&name](int i) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true)};
+    return Row(fields);
+  };
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  ASSERT_NE(INVALID_PAGE_ID, table_heap->GetFreeSpaceMapPageId());
+  std::vector<RowId> rids;
+  for (int i = 0; i < 1000; i++) {
+    Row row = make_row(i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  uint32_t page_count = table_heap->GetPageCount();
+  ASSERT_LT(1, page_count);
+
+  // Scenario: space freed in the first page is reused before the last page.
+  ASSERT_TRUE(table_heap->MarkDelete(rids[0], nullptr));
+  table_heap->ApplyDelete(rids[0], nullptr);
+  Row row = make_row(1000);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(rids[0].GetPageId(), row.GetRowId().GetPageId());
+  EXPECT_EQ(page_count, table_heap->GetPageCount());
+
+  // Scenario: the map is read back from its pages, the next insert does not walk the chain.
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  page_id_t fsm_page_id = table_heap->GetFreeSpaceMapPageId();
+  delete table_heap;
+  table_heap = TableHeap::Create(bpm, first_page_id, fsm_page_id, schema.get(), nullptr, nullptr);
+  EXPECT_EQ(page_count, table_heap->GetPageCount());
+  ASSERT_TRUE(table_heap->MarkDelete(rids[500], nullptr));
+  table_heap->ApplyDelete(rids[500], nullptr);
+  row = make_row(1001);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  EXPECT_EQ(rids[500].GetPageId(), row.GetRowId().GetPageId());
+  EXPECT_EQ(page_count, table_heap->GetPageCount());
+  delete table_heap;
+
+  // Scenario: a heap without map pages builds its map from the chain.
+  table_heap = TableHeap::Create(bpm, first_page_id, schema.get(), nullptr, nullptr);
+  ASSERT_EQ(INVALID_PAGE_ID, table_heap->GetFreeSpaceMapPageId());
+  for (int i = 0; i < 1000; i++) {
+    row = make_row(2000 + i);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+  EXPECT_LT(page_count, table_heap->GetPageCount());
+  size_t num_rows = 0;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++) {
+    num_rows++;
+  }
+  EXPECT_EQ(2000, num_rows);
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, BulkInsertTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  Fields fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, name, 64, true)};
+  Row first_row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(first_row, nullptr));
+
+  // Scenario: the rows fill new pages after the existing one, their row ids come back in order.
+  const int row_nums = 5000;
+  RowBatch batch;
+  for (int i = 0; i < row_nums; i++) {
+    Fields row_fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 1 + i % 64, true)};
+    batch.AddRow(row_fields);
+  }
+  ASSERT_TRUE(table_heap->BulkInsert(batch, nullptr));
+  ASSERT_EQ(row_nums, batch.GetRowIds().size());
+  EXPECT_NE(first_row.GetRowId().GetPageId(), batch.GetRowIds()[0].GetPageId());
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(batch.GetRow(i).GetRowId().Get(), batch.GetRowIds()[i].Get());
+    Row row(batch.GetRowIds()[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  int i = -1;
+  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); iter++, i++) {
+    ASSERT_EQ(CmpBool::kTrue, iter->GetField(0)->CompareEquals(Field(TypeId::kTypeInt, i)));
+  }
+  ASSERT_EQ(row_nums, i);
+
+  // Scenario: the free-space map knows the new pages, the next insert goes to the last one.
+  uint32_t page_count = table_heap->GetPageCount();
+  Row last_row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(last_row, nullptr));
+  EXPECT_EQ(page_count, table_heap->GetPageCount());
+
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TableHeapTest, TableScannerTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'x', sizeof(name));
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr);
+  const int row_nums = 3000;
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), i % 7 == 0 ? Field(TypeId::kTypeChar)
+                                                          : Field(TypeId::kTypeChar, name, 1 + i % 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    row_ids.push_back(row.GetRowId());
+  }
+  // deleted tuples are skipped
+  for (int i = 0; i < row_nums; i += 10) {
+    ASSERT_TRUE(table_heap->MarkDelete(row_ids[i], nullptr));
+  }
+
+  // Scenario: the scanner sees the tuples the iterator does, in the same order.
+  auto iter = table_heap->Begin(nullptr);
+  {
+    TableScanner scanner(table_heap, nullptr);
+    int count = 0;
+    for (; scanner.Next(); ++iter, count++) {
+      ASSERT_NE(table_heap->End(), iter);
+      const RowView &view = scanner.GetView();
+      ASSERT_EQ(iter->GetRowId().Get(), view.GetRowId().Get());
+      ASSERT_EQ(2, view.GetFieldCount());
+      for (uint32_t j = 0; j < 2; j++) {
+        ASSERT_EQ(iter->GetField(j)->IsNull(), view.IsNull(j));
+        ASSERT_NE(CmpBool::kFalse, view.GetField(j).CompareEquals(*iter->GetField(j)));
+      }
+    }
+    ASSERT_EQ(table_heap->End(), iter);
+    ASSERT_EQ(row_nums - row_nums / 10, count);
+    ASSERT_FALSE(scanner.Next());
+  }
+
+  // Scenario: a scanner left halfway unpins its page.
+  {
+    TableScanner scanner(table_heap, nullptr);
+    ASSERT_TRUE(scanner.Next());
+  }
+  Page *first_page = bpm->FetchPage(table_heap->GetFirstPageId());
+  ASSERT_EQ(1, first_page->GetPinCount());
+  bpm->UnpinPage(table_heap->GetFirstPageId(), false);
+
+  delete table_heap;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
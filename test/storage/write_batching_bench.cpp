@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+
+static const std::string db_name = "write_batching_bench.db";
+
+static const size_t kPoolSize = 16384;
+static const int kRowNums = 20000;
+
+/**
+ * Bulk insert into a table heap and checkpoint it, once with every page write synced on its own and once with the
+ * writes batched and synced by the checkpoint. Prints the pages written per second of the checkpoint.
+ */
+TEST(WriteBatchingBench, Checkpoint) {
+  printf("%d rows\n", kRowNums);
+  printf("%14s %10s %10s %12s\n", "mode", "writes", "ms", "pages/sec");
+  for (auto write_mode : {DiskWriteMode::WRITE_THROUGH, DiskWriteMode::BATCHED}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name);
+    disk_mgr->SetWriteMode(write_mode);
+    auto *bpm = new BufferPoolManager(kPoolSize, disk_mgr);
+    // only the checkpoint writes pages back
+    bpm->SetDirtyRatioThreshold(1.0);
+    std::vector<Column *> columns{new Column("id", TypeId::kTypeInt, 0, false, false),
+                                  new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                  new Column("account", TypeId::kTypeFloat, 2, true, false)};
+    TableSchema table_schema(columns);
+    TableHeap *table_heap = TableHeap::Create(bpm, &table_schema, nullptr, nullptr, nullptr);
+    char name[64];
+    memset(name, 'x', sizeof(name));
+    for (int i = 0; i < kRowNums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 64, true),
+                                Field(TypeId::kTypeFloat, static_cast<float>(i))};
+      Row row(fields);
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+
+    DiskIOStats before = disk_mgr->GetIOStats();
+    auto start = std::chrono::steady_clock::now();
+    bpm->FlushAllPages();
+    auto stop = std::chrono::steady_clock::now();
+    uint64_t writes = disk_mgr->GetIOStats().writes_ - before.writes_;
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+    printf("%14s %10lu %10.1f %12.0f\n", write_mode == DiskWriteMode::BATCHED ? "batched" : "write-through", writes,
+           ms, writes * 1000.0 / ms);
+    auto pages = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages();
+    // the data pages, one bitmap and the meta page
+    EXPECT_EQ(pages + 2, writes);
+
+    delete table_heap;
+    delete bpm;
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}